@@ -0,0 +1,242 @@
+#define _DEFAULT_SOURCE
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sat_api.h"
+
+/******************************************************************************
+ * Benchmark
+ *
+ * usage: sat_bench [-r repetitions] [-t seconds] [-f csv|json] [-p] [-T prefix] (file|directory)...
+ *
+ * Every cnf (files ending with .cnf, possibly compressed, when a directory is
+ * given) is solved repetitions times, each time in a child process, so that the
+ * peak resident set size of the run is its own, and a run which does not stop
+ * by itself at the timeout is killed. -p runs sat_preprocess() before solving.
+ * -T traces every run (the library must be built with make TRACE=1): the summary
+ * of the phases goes to stderr, and the timeline of run n to <prefix>n.json.
+ *
+ * The rates are taken over the search time (wall time minus parse time).
+ ******************************************************************************/
+
+#define KILL_GRACE 10  // seconds given to a run past its timeout before it is killed
+#define TRACE_EVENTS ((c2dSize)1 << 20)  // events kept for the timeline of a run
+
+typedef struct bench_run {
+  int result;
+  double wall_time;
+  double parse_time;
+  c2dSize decisions;
+  c2dSize propagations;
+  c2dSize conflicts;
+} BenchRun;
+
+typedef struct bench_options {
+  double timeout;
+  BOOLEAN preprocess;
+  const char* trace_prefix;  // NULL if the runs are not traced
+} BenchOptions;
+
+// writes the trace of run number index of the cnf
+static void write_trace(const SatTracer* tracer, const char* trace_prefix, const char* file_name, int index) {
+  fprintf(stderr, "c run %d: %s\n", index, file_name);
+  sat_tracer_print_summary(tracer, stderr);
+  char* trace_name = malloc(strlen(trace_prefix) + 32);
+  sprintf(trace_name, "%s%d.json", trace_prefix, index);
+  if (!sat_tracer_write_timeline(tracer, trace_name)) fprintf(stderr, "cannot write %s\n", trace_name);
+  free(trace_name);
+}
+
+// solves the cnf in the child process, and writes the run to fd
+static void run_child(const char* file_name, const BenchOptions* options, int index, int fd) {
+  double start = sat_clock();
+  double timeout = options->timeout;
+  BenchRun run;
+  memset(&run, 0, sizeof(run));
+  run.result = -1;
+  SatTracer* tracer = NULL;
+  if (options->trace_prefix != NULL) {
+    tracer = sat_tracer_new(TRACE_EVENTS);
+    sat_tracer_start(tracer);
+  }
+
+  SatState* sat_state = sat_state_new(file_name);
+  if (sat_state != NULL) {
+    run.parse_time = sat_parse_time(sat_state);
+    // a budget eaten by parsing is a timeout (a limit of 0 would mean no limit)
+    double left = timeout - (sat_clock() - start);
+    if (timeout > 0) sat_set_solve_limits(sat_state, 0, 0, left);
+    if (timeout > 0 && left <= 0) {
+      run.result = SAT_UNKNOWN;
+    } else {
+      if (options->preprocess) sat_preprocess(sat_state);
+      run.result = sat_solve(sat_state);
+    }
+    SatStats stats = sat_stats(sat_state);
+    run.decisions = stats.decisions;
+    run.propagations = stats.propagations;
+    run.conflicts = stats.conflicts;
+  }
+  run.wall_time = sat_clock() - start;
+  if (tracer != NULL) {
+    sat_tracer_stop(tracer);
+    write_trace(tracer, options->trace_prefix, file_name, index);
+    sat_tracer_free(tracer);
+  }
+  if (write(fd, &run, sizeof(run)) != sizeof(run)) _exit(1);
+  _exit(0);
+}
+
+// runs the cnf once, returns 0 if the child process failed (then only the wall time of the run
+// is set); *peak_rss is in kilobytes
+static BOOLEAN bench_once(const char* file_name, const BenchOptions* options, int index, BenchRun* run,
+                          long* peak_rss) {
+  double start = sat_clock();
+  memset(run, 0, sizeof(*run));
+  run->result = -1;
+  int fds[2];
+  if (pipe(fds) != 0) return 0;
+  pid_t pid = fork();
+  if (pid < 0) return 0;
+  if (pid == 0) {
+    close(fds[0]);
+    if (options->timeout > 0) alarm((unsigned int)options->timeout + KILL_GRACE);
+    run_child(file_name, options, index, fds[1]);
+  }
+
+  close(fds[1]);
+  ssize_t n = read(fds[0], run, sizeof(*run));
+  close(fds[0]);
+  int status;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) < 0) return 0;
+  *peak_rss = usage.ru_maxrss;
+  if (n == sizeof(*run) && WIFEXITED(status) && WEXITSTATUS(status) == 0) return 1;
+
+  memset(run, 0, sizeof(*run));
+  run->result = -1;
+  run->wall_time = sat_clock() - start;
+  return 0;
+}
+
+static const char* result_name(int result) {
+  switch (result) {
+    case SAT_SATISFIABLE: return "SAT";
+    case SAT_UNSATISFIABLE: return "UNSAT";
+    case SAT_UNKNOWN: return "UNKNOWN";
+    default: return "ERROR";
+  }
+}
+
+static double rate(c2dSize count, double seconds) {
+  return seconds > 0 ? count / seconds : 0;
+}
+
+// writes the string as a JSON string
+static void print_json_string(const char* str) {
+  putchar('"');
+  for (const unsigned char* p = (const unsigned char*)str; *p != '\0'; p++) {
+    if (*p == '"' || *p == '\\') printf("\\%c", *p);
+    else if (*p < 0x20) printf("\\u%04x", *p);
+    else putchar(*p);
+  }
+  putchar('"');
+}
+
+static void print_run(const char* format, BOOLEAN first, const char* file_name, int repetition,
+                      const BenchRun* run, long peak_rss) {
+  double search_time = run->wall_time - run->parse_time;
+  if (strcmp(format, "json") == 0) {
+    printf("%s\n  {\"file\": ", first ? "" : ",");
+    print_json_string(file_name);
+    printf(", \"run\": %d, \"result\": \"%s\", \"wall_s\": %.6f, \"parse_s\": %.6f, "
+           "\"decisions\": %lu, \"propagations\": %lu, \"conflicts\": %lu, \"decisions_per_s\": %.1f, "
+           "\"propagations_per_s\": %.1f, \"conflicts_per_s\": %.1f, \"peak_rss_kb\": %ld}",
+           repetition, result_name(run->result), run->wall_time, run->parse_time,
+           run->decisions, run->propagations, run->conflicts, rate(run->decisions, search_time),
+           rate(run->propagations, search_time), rate(run->conflicts, search_time), peak_rss);
+  } else {
+    printf("%s,%d,%s,%.6f,%.6f,%lu,%lu,%lu,%.1f,%.1f,%.1f,%ld\n", file_name, repetition,
+           result_name(run->result), run->wall_time, run->parse_time, run->decisions, run->propagations,
+           run->conflicts, rate(run->decisions, search_time), rate(run->propagations, search_time),
+           rate(run->conflicts, search_time), peak_rss);
+  }
+  fflush(stdout);
+}
+
+static BOOLEAN cnf_file_name(const char* name) {
+  const char* suffixes[] = {".cnf", ".cnf.gz", ".cnf.bz2", ".cnf.xz"};
+  size_t len = strlen(name);
+  for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
+    size_t n = strlen(suffixes[i]);
+    if (len > n && strcmp(name + len - n, suffixes[i]) == 0) return 1;
+  }
+  return 0;
+}
+
+static int compare_names(const void* a, const void* b) {
+  return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// appends the cnf files of path (a file, or the cnf files of a directory in name order)
+static void collect_files(const char* path, char*** files, size_t* num_files, size_t* cap) {
+  DIR* dir = opendir(path);
+  size_t first = *num_files;
+  if (dir == NULL) {
+    if (*num_files == *cap) *files = realloc(*files, sizeof(char*) * (*cap *= 2));
+    (*files)[(*num_files)++] = strdup(path);
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (!cnf_file_name(entry->d_name)) continue;
+    if (*num_files == *cap) *files = realloc(*files, sizeof(char*) * (*cap *= 2));
+    char* file_name = malloc(strlen(path) + strlen(entry->d_name) + 2);
+    sprintf(file_name, "%s/%s", path, entry->d_name);
+    (*files)[(*num_files)++] = file_name;
+  }
+  closedir(dir);
+  qsort(*files + first, *num_files - first, sizeof(char*), compare_names);
+}
+
+int main(int argc, char* argv[]) {
+  int repetitions = 1;
+  const char* format = "csv";
+  BenchOptions options = {0, 0, NULL};
+  size_t num_files = 0, cap = 16;
+  char** files = malloc(sizeof(char*) * cap);
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) repetitions = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) options.timeout = atof(argv[++i]);
+    else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) format = argv[++i];
+    else if (strcmp(argv[i], "-p") == 0) options.preprocess = 1;
+    else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) options.trace_prefix = argv[++i];
+    else collect_files(argv[i], &files, &num_files, &cap);
+  }
+  if (num_files == 0) {
+    fprintf(stderr, "usage: %s [-r repetitions] [-t seconds] [-f csv|json] [-p] [-T prefix] (file|directory)...\n",
+            argv[0]);
+    return 1;
+  }
+
+  if (strcmp(format, "json") == 0) printf("[");
+  else printf("file,run,result,wall_s,parse_s,decisions,propagations,conflicts,"
+              "decisions_per_s,propagations_per_s,conflicts_per_s,peak_rss_kb\n");
+  BOOLEAN first = 1;
+  int index = 0;
+  for (size_t i = 0; i < num_files; i++) {
+    for (int r = 1; r <= repetitions; r++) {
+      BenchRun run;
+      long peak_rss = 0;
+      bench_once(files[i], &options, ++index, &run, &peak_rss);
+      print_run(format, first, files[i], r, &run, peak_rss);
+      first = 0;
+    }
+    free(files[i]);
+  }
+  if (strcmp(format, "json") == 0) printf("\n]\n");
+  free(files);
+  return 0;
+}
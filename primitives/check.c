@@ -0,0 +1,1452 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+
+#include "sat_api.h"
+
+/******************************************************************************
+ * Behavior checks:
+ * --Each check builds small random cnfs from fixed seeds, so every run sees the same
+ * cnfs, and compares what the library answers with the enumeration of all the
+ * assignments of the cnf
+ * --Run by make check, which fails if one of the checks does
+ ******************************************************************************/
+
+static c2dSize num_checks = 0;
+static c2dSize num_failed = 0;
+
+#define CHECK(cond, ...)                                     \
+  do {                                                       \
+    ++num_checks;                                            \
+    if (!(cond)) {                                           \
+      ++num_failed;                                          \
+      fprintf(stderr, "%s:%d: check failed: ", __FILE__, __LINE__); \
+      fprintf(stderr, __VA_ARGS__);                          \
+      fprintf(stderr, "\n");                                 \
+    }                                                        \
+  } while (0)
+
+/******************************************************************************
+ * Random cnfs
+ ******************************************************************************/
+
+static uint64_t random_state;
+
+static void seed_random(uint64_t seed) {
+  random_state = seed * 0x9E3779B97F4A7C15ULL + 1;
+}
+
+//xorshift64*
+static uint64_t next_random(void) {
+  random_state ^= random_state >> 12;
+  random_state ^= random_state << 25;
+  random_state ^= random_state >> 27;
+  return random_state * 0x2545F4914F6CDD1DULL;
+}
+
+//returns a random number in [0, n)
+static c2dSize random_below(c2dSize n) {
+  return (c2dSize)(next_random() % n);
+}
+
+//a cnf kept as its literals, each clause being terminated by 0
+typedef struct test_cnf {
+  c2dSize num_vars;
+  c2dSize num_clauses;
+  c2dLiteral* lits;
+  c2dSize num_lits;
+} TestCnf;
+
+//returns a cnf of num_clauses clauses over num_vars variables, each one with min_size to
+//max_size distinct variables (at most num_vars)
+static TestCnf sized_cnf(uint64_t seed, c2dSize num_vars, c2dSize num_clauses, c2dSize min_size, c2dSize max_size) {
+  seed_random(seed);
+  if (max_size > num_vars) max_size = num_vars;
+  if (min_size > max_size) min_size = max_size;
+  TestCnf cnf = {num_vars, num_clauses, malloc(sizeof(c2dLiteral) * num_clauses * (max_size + 1)), 0};
+  for (c2dSize i = 0; i < num_clauses; i++) {
+    c2dSize size = min_size + random_below(max_size - min_size + 1);
+    c2dSize start = cnf.num_lits;
+    while (cnf.num_lits - start < size) {
+      c2dLiteral var = (c2dLiteral)(1 + random_below(num_vars));
+      BOOLEAN repeated = 0;
+      for (c2dSize j = start; j < cnf.num_lits; j++) repeated |= cnf.lits[j] == var || cnf.lits[j] == -var;
+      if (!repeated) cnf.lits[cnf.num_lits++] = random_below(2) ? var : -var;
+    }
+    cnf.lits[cnf.num_lits++] = 0;
+  }
+  return cnf;
+}
+
+//returns a cnf of num_clauses clauses over num_vars variables, each one with 1 to max_size
+//distinct variables (at most num_vars)
+static TestCnf random_cnf(uint64_t seed, c2dSize num_vars, c2dSize num_clauses, c2dSize max_size) {
+  return sized_cnf(seed, num_vars, num_clauses, 1, max_size);
+}
+
+//appends a clause to the cnf
+static void add_test_clause(TestCnf* cnf, const c2dLiteral* lits, c2dSize size) {
+  cnf->lits = realloc(cnf->lits, sizeof(c2dLiteral) * (cnf->num_lits + size + 1));
+  memcpy(cnf->lits + cnf->num_lits, lits, sizeof(c2dLiteral) * size);
+  cnf->num_lits += size;
+  cnf->lits[cnf->num_lits++] = 0;
+  ++cnf->num_clauses;
+}
+
+//returns the cnf in DIMACS format, to be freed by the caller
+static char* dimacs_text(const TestCnf* cnf, c2dSize* len) {
+  c2dSize cap = 64 + 24 * (cnf->num_lits + 1);
+  char* text = malloc(cap);
+  c2dSize n = (c2dSize)sprintf(text, "p cnf %lu %lu\n", cnf->num_vars, cnf->num_clauses);
+  for (c2dSize i = 0; i < cnf->num_lits; i++) {
+    n += (c2dSize)sprintf(text + n, cnf->lits[i] == 0 ? "0\n" : "%ld ", cnf->lits[i]);
+  }
+  *len = n;
+  return text;
+}
+
+//returns the parsed DIMACS text of the cnf
+static DimacsCnf* test_dimacs(const TestCnf* cnf) {
+  c2dSize len;
+  char* text = dimacs_text(cnf, &len);
+  DimacsCnf* dimacs = dimacs_parse(text, len);
+  free(text);
+  return dimacs;
+}
+
+//returns a sat state of the cnf, parsed from its DIMACS text
+static SatState* test_state(const TestCnf* cnf) {
+  DimacsCnf* dimacs = test_dimacs(cnf);
+  if (dimacs == NULL) return NULL;
+  SatState* sat_state = sat_state_new_from_cnf(dimacs);
+  dimacs_free(dimacs);
+  return sat_state;
+}
+
+/******************************************************************************
+ * Enumeration
+ ******************************************************************************/
+
+//returns 1 if the assignment (1 or -1 by variable) satisfies the cnf, 0 otherwise
+static BOOLEAN satisfies(const TestCnf* cnf, const BOOLEAN* assignment) {
+  BOOLEAN satisfied = 0;
+  for (c2dSize i = 0; i < cnf->num_lits; i++) {
+    c2dLiteral lit = cnf->lits[i];
+    if (lit == 0) {
+      if (!satisfied) return 0;
+      satisfied = 0;
+    }
+    else if (assignment[lit > 0 ? lit : -lit] == (lit > 0 ? 1 : -1)) satisfied = 1;
+  }
+  return 1;
+}
+
+//sets the assignment to the given bits, variable i taking bit i - 1
+static void assignment_of(c2dSize bits, c2dSize num_vars, BOOLEAN* assignment) {
+  for (c2dSize v = 1; v <= num_vars; v++) assignment[v] = (bits >> (v - 1)) & 1 ? 1 : -1;
+}
+
+//returns the number of assignments satisfying the cnf and setting the given literals
+static c2dSize count_models(const TestCnf* cnf, const c2dLiteral* lits, c2dSize num_lits) {
+  BOOLEAN* assignment = malloc(sizeof(BOOLEAN) * (cnf->num_vars + 1));
+  c2dSize count = 0;
+  for (c2dSize bits = 0; bits < ((c2dSize)1 << cnf->num_vars); bits++) {
+    assignment_of(bits, cnf->num_vars, assignment);
+    BOOLEAN sets = 1;
+    for (c2dSize i = 0; i < num_lits; i++) sets &= assignment[lits[i] > 0 ? lits[i] : -lits[i]] == (lits[i] > 0 ? 1 : -1);
+    if (sets && satisfies(cnf, assignment)) ++count;
+  }
+  free(assignment);
+  return count;
+}
+
+/******************************************************************************
+ * Search
+ ******************************************************************************/
+
+//sat_solve() agrees with the enumeration, and its model satisfies the cnf; a second call
+//gives the same answer
+static void check_solve(void) {
+  for (uint64_t seed = 0; seed < 300; seed++) {
+    c2dSize num_vars = 3 + seed % 10;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (2 + seed % 3), 4);
+    SatState* sat_state = test_state(&cnf);
+    BOOLEAN sat = count_models(&cnf, NULL, 0) > 0;
+    for (int call = 0; call < 2; call++) {
+      int result = sat_solve(sat_state);
+      CHECK(result == (sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu call %d: result %d", seed, call, result);
+      if (result == SAT_SATISFIABLE) {
+        CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu call %d: the model falsifies the cnf", seed, call);
+      }
+    }
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+}
+
+//sets the assignment to the literals instantiated in sat state, -1 for the free variables
+static void instantiated_assignment(SatState* sat_state, c2dSize num_vars, BOOLEAN* assignment) {
+  for (c2dSize v = 1; v <= num_vars; v++) {
+    assignment[v] = sat_implied_literal(sat_pos_literal(sat_index2var(v, sat_state))) ? 1 : -1;
+  }
+}
+
+// a search which deletes the learned clauses after every conflict, while the learned clause
+// is still pending, so the clause is asserted through sat_state->asserted_clause; like
+// sat_solve(), it marks the sat state inconsistent once the empty clause is learned
+static int reducing_search(SatState* sat_state) {
+  if (!sat_unit_resolution(sat_state)) return SAT_UNSATISFIABLE;
+  for (;;) {
+    Lit* lit = sat_next_decision(sat_state);
+    if (lit == NULL) return SAT_SATISFIABLE;
+    Clause* learned = sat_decide_literal(lit, sat_state);
+    while (learned != NULL) {
+      sat_reduce_learned_clauses(sat_state);
+      learned = sat_state->asserted_clause;
+      if (learned->size == 0) {
+        sat_state->inconsistent = 1;
+        return SAT_UNSATISFIABLE;
+      }
+      while (!sat_at_assertion_level(learned, sat_state)) sat_undo_decide_literal(sat_state);
+      learned = sat_assert_clause(learned, sat_state);
+    }
+  }
+}
+
+//with learned clauses deleted every few conflicts, sat_solve() still agrees with the
+//enumeration; so does a search deleting them between sat_decide_literal() and
+//sat_assert_clause(), and sat_solve() on the sat state it leaves
+static void check_reduce(void) {
+  BOOLEAN assignment[32];
+  c2dSize num_reductions = 0;
+  for (uint64_t seed = 0; seed < 120; seed++) {
+    c2dSize num_vars = 10 + seed % 7;
+    TestCnf cnf = sized_cnf(seed, num_vars, num_vars * 4 + seed % 8, 3, 3);
+    BOOLEAN sat = count_models(&cnf, NULL, 0) > 0;
+
+    SatState* sat_state = test_state(&cnf);
+    sat_set_reduce_schedule(sat_state, 10, 5);
+    for (int call = 0; call < 2; call++) {
+      int result = sat_solve(sat_state);
+      CHECK(result == (sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu call %d: result %d", seed, call, result);
+      if (result == SAT_SATISFIABLE) {
+        CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu call %d: the model falsifies the cnf", seed, call);
+      }
+    }
+    num_reductions += sat_state->num_reductions;
+    sat_state_free(sat_state);
+
+    sat_state = test_state(&cnf);
+    sat_set_reduce_schedule(sat_state, 0, 0);
+    int result = reducing_search(sat_state);
+    CHECK(result == (sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu: reducing search result %d", seed, result);
+    if (result == SAT_SATISFIABLE) {
+      instantiated_assignment(sat_state, num_vars, assignment);
+      CHECK(satisfies(&cnf, assignment), "seed %lu: the reducing search assignment falsifies the cnf", seed);
+    }
+    result = sat_solve(sat_state);
+    CHECK(result == (sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu: result %d after the reducing search", seed, result);
+    if (result == SAT_SATISFIABLE) {
+      CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu: the model falsifies the cnf", seed);
+    }
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+  CHECK(num_reductions > 0, "no learned clauses were deleted");
+
+  // enough learned clauses for the reductions to compact their arena, with a learned clause
+  // pending; too many variables to enumerate, so the answer is compared with a plain search
+  TestCnf cnf = sized_cnf(7, 250, 1150, 3, 3);
+  SatState* sat_state = test_state(&cnf);
+  int expected = sat_solve(sat_state);
+  sat_state_free(sat_state);
+
+  sat_state = test_state(&cnf);
+  sat_set_reduce_schedule(sat_state, 0, 0);
+  sat_set_solve_limits(sat_state, 15000, 0, 0);
+  sat_solve(sat_state);
+  Clause* learned = NULL;
+  for (Lit* lit = sat_next_decision(sat_state); lit != NULL && learned == NULL; lit = sat_next_decision(sat_state)) {
+    learned = sat_decide_literal(lit, sat_state);
+  }
+  CHECK(learned != NULL, "no clause was learned");
+  if (learned != NULL) {
+    c2dSize size = learned->size;
+    for (int i = 0; i < 3; i++) sat_reduce_learned_clauses(sat_state);
+    CHECK(sat_state->asserted_clause->size == size, "the pending clause changed");
+  }
+  sat_set_solve_limits(sat_state, 0, 0, 0);
+  int result = sat_solve(sat_state);
+  CHECK(result == expected, "result %d after reducing with a pending clause, %d without", result, expected);
+  if (result == SAT_SATISFIABLE) {
+    CHECK(satisfies(&cnf, sat_model(sat_state)), "the model falsifies the cnf");
+  }
+  sat_state_free(sat_state);
+  free(cnf.lits);
+}
+
+//sets lits to size random literals over num_vars variables, which may repeat
+static void random_literals(c2dSize num_vars, c2dLiteral* lits, c2dSize size) {
+  for (c2dSize i = 0; i < size; i++) {
+    c2dLiteral var = (c2dLiteral)(1 + random_below(num_vars));
+    lits[i] = random_below(2) ? var : -var;
+  }
+}
+
+//returns 1 if every literal of lits is one of the assumptions, 0 otherwise
+static BOOLEAN among(const c2dLiteral* lits, c2dSize size, const c2dLiteral* assumptions, c2dSize num_assumptions) {
+  for (c2dSize i = 0; i < size; i++) {
+    BOOLEAN found = 0;
+    for (c2dSize j = 0; j < num_assumptions; j++) found |= lits[i] == assumptions[j];
+    if (!found) return 0;
+  }
+  return 1;
+}
+
+//sat_solve_with_assumptions() agrees with the enumeration of the assignments setting the
+//assumptions, over successive calls on one sat state which gets clauses added in between;
+//on SAT the model sets the assumptions, on UNSAT the failed assumptions alone rule out every
+//model
+static void check_assumptions(void) {
+  c2dLiteral assumptions[64];
+  c2dLiteral clause[4];
+  for (uint64_t seed = 0; seed < 150; seed++) {
+    c2dSize num_vars = 3 + seed % 10;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 3), 4);
+    SatState* sat_state = test_state(&cnf);
+    for (int call = 0; call < 12; call++) {
+      // some calls assume more literals than there are variables, repeating them
+      c2dSize num_assumptions = call % 4 == 3 ? 2 * num_vars + random_below(40) : random_below(num_vars + 1);
+      random_literals(num_vars, assumptions, num_assumptions);
+      c2dSize count = count_models(&cnf, assumptions, num_assumptions);
+      int result = sat_solve_with_assumptions(assumptions, num_assumptions, sat_state);
+      CHECK(result == (count > 0 ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu call %d: result %d", seed, call, result);
+      if (result == SAT_SATISFIABLE) {
+        const BOOLEAN* model = sat_model(sat_state);
+        CHECK(satisfies(&cnf, model), "seed %lu call %d: the model falsifies the cnf", seed, call);
+        for (c2dSize i = 0; i < num_assumptions; i++) {
+          c2dLiteral lit = assumptions[i];
+          CHECK(model[lit > 0 ? lit : -lit] == (lit > 0 ? 1 : -1), "seed %lu call %d: assumption %ld is false", seed, call, lit);
+        }
+      }
+      else if (result == SAT_UNSATISFIABLE) {
+        c2dSize num_failed;
+        const c2dLiteral* failed = sat_failed_assumptions(sat_state, &num_failed);
+        CHECK(among(failed, num_failed, assumptions, num_assumptions), "seed %lu call %d: a failed literal is not assumed", seed, call);
+        CHECK(count_models(&cnf, failed, num_failed) == 0, "seed %lu call %d: the failed assumptions have a model", seed, call);
+      }
+
+      if (call % 3 == 2) {
+        c2dSize size = 2 + random_below(3);
+        if (size > num_vars) size = num_vars;
+        random_literals(num_vars, clause, size);
+        CHECK(sat_add_clause(clause, size, sat_state) != NULL, "seed %lu call %d: clause not added", seed, call);
+        add_test_clause(&cnf, clause, size);
+      }
+    }
+
+    // literals which are not literals of the cnf
+    c2dLiteral invalid[2] = {1, (c2dLiteral)num_vars + 1};
+    CHECK(sat_solve_with_assumptions(invalid, 2, sat_state) == SAT_UNKNOWN, "seed %lu: assumed a variable beyond the cnf", seed);
+    invalid[1] = 0;
+    CHECK(sat_solve_with_assumptions(invalid, 2, sat_state) == SAT_UNKNOWN, "seed %lu: assumed literal 0", seed);
+    CHECK(sat_add_clause(invalid, 2, sat_state) == NULL, "seed %lu: added literal 0", seed);
+
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+}
+
+/******************************************************************************
+ * Preprocessing
+ ******************************************************************************/
+
+//after sat_preprocess(), sat_solve() and sat_solve_with_assumptions() still agree with the
+//enumeration of the original cnf: the model, extended to the eliminated variables, satisfies
+//it and its literals are implied; assuming an eliminated variable gives SAT_UNKNOWN
+static void check_preprocess(void) {
+  c2dLiteral assumptions[16];
+  c2dSize num_eliminated = 0;
+  for (uint64_t seed = 0; seed < 300; seed++) {
+    c2dSize num_vars = 3 + seed % 12;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 4), 3);
+    SatState* sat_state = test_state(&cnf);
+    c2dSize count = count_models(&cnf, NULL, 0);
+    BOOLEAN consistent = sat_preprocess(sat_state);
+    CHECK(consistent || count == 0, "seed %lu: a satisfiable cnf is found unsatisfiable", seed);
+    num_eliminated += sat_state->num_eliminated_vars;
+
+    int result = sat_solve(sat_state);
+    CHECK(result == (count > 0 ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu: result %d", seed, result);
+    if (result == SAT_SATISFIABLE) {
+      const BOOLEAN* model = sat_model(sat_state);
+      CHECK(satisfies(&cnf, model), "seed %lu: the extended model falsifies the cnf", seed);
+      for (c2dSize v = 1; v <= num_vars; v++) {
+        Var* var = sat_index2var(v, sat_state);
+        Lit* lit = model[v] > 0 ? sat_pos_literal(var) : sat_neg_literal(var);
+        CHECK(sat_implied_literal(lit), "seed %lu: the literal of %lu in the model is not implied", seed, v);
+      }
+    }
+
+    for (int call = 0; call < 6 && consistent; call++) {
+      c2dSize num_assumptions = 0;
+      BOOLEAN assumes_eliminated = 0;
+      for (c2dSize i = random_below(num_vars + 1); i > 0; i--) {
+        c2dLiteral var = (c2dLiteral)(1 + random_below(num_vars));
+        assumes_eliminated |= sat_state->eliminated[var];
+        assumptions[num_assumptions++] = random_below(2) ? var : -var;
+      }
+      result = sat_solve_with_assumptions(assumptions, num_assumptions, sat_state);
+      if (assumes_eliminated) {
+        CHECK(result == SAT_UNKNOWN, "seed %lu call %d: assumed an eliminated variable", seed, call);
+        continue;
+      }
+      count = count_models(&cnf, assumptions, num_assumptions);
+      CHECK(result == (count > 0 ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu call %d: result %d", seed, call, result);
+      if (result == SAT_SATISFIABLE) {
+        CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu call %d: the extended model falsifies the cnf", seed, call);
+      }
+    }
+
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+  CHECK(num_eliminated > 0, "no variable was eliminated");
+}
+
+/******************************************************************************
+ * Probing
+ ******************************************************************************/
+
+//sat_probe() finds a cnf unsatisfiable only if the enumeration does, and every literal it
+//fixes holds in all the models; with small budgets the rounds go on from one call to the
+//next. sat_solve() then agrees with the enumeration, and probing between its restarts does
+//not change its answers
+static void check_probe(void) {
+  c2dSize num_fixed = 0;
+  c2dSize num_failed_literals = 0;
+  c2dSize num_rounds = 0;
+  for (uint64_t seed = 0; seed < 300; seed++) {
+    c2dSize num_vars = 3 + seed % 12;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 4), 3);
+    SatState* sat_state = test_state(&cnf);
+    c2dSize count = count_models(&cnf, NULL, 0);
+    c2dSize budget = seed % 3 == 0 ? 4 : 1000;
+
+    BOOLEAN consistent = 1;
+    for (int call = 0; call < 3 && consistent; call++) {
+      consistent = sat_probe(sat_state, budget);
+      CHECK(consistent || count == 0, "seed %lu call %d: a satisfiable cnf is found unsatisfiable", seed, call);
+    }
+    for (c2dSize v = 1; v <= num_vars && consistent; v++) {
+      Var* var = sat_index2var(v, sat_state);
+      if (!sat_instantiated_var(var)) continue;
+      c2dLiteral opposite = sat_implied_literal(sat_pos_literal(var)) ? -(c2dLiteral)v : (c2dLiteral)v;
+      CHECK(count_models(&cnf, &opposite, 1) == 0, "seed %lu: a model sets %ld, fixed the other way", seed, opposite);
+      ++num_fixed;
+    }
+    num_failed_literals += sat_state->num_failed_literals;
+
+    int result = sat_solve(sat_state);
+    CHECK(result == (count > 0 ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu: result %d after probing", seed, result);
+    if (result == SAT_SATISFIABLE) {
+      CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu: the model falsifies the cnf", seed);
+    }
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+
+  // 3-cnfs which take many restarts, probed after each one; too many variables to enumerate,
+  // so the answers are compared with a plain search
+  for (uint64_t seed = 0; seed < 20; seed++) {
+    TestCnf cnf = sized_cnf(seed, 150, 615 + 5 * seed, 3, 3);
+    SatState* sat_state = test_state(&cnf);
+    int expected = sat_solve(sat_state);
+    sat_state_free(sat_state);
+
+    sat_state = test_state(&cnf);
+    sat_set_probe_schedule(sat_state, 1, seed % 2 == 0 ? 50 : 5000);
+    int result = sat_solve(sat_state);
+    CHECK(result == expected, "seed %lu: result %d when probing, %d without", seed, result, expected);
+    if (result == SAT_SATISFIABLE) {
+      CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu: the model falsifies the cnf when probing", seed);
+    }
+    num_rounds += sat_state->probe_next_var != 1;
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+  CHECK(num_fixed > 0, "no literal was fixed");
+  CHECK(num_failed_literals > 0, "no failed literal was found");
+  CHECK(num_rounds > 0, "sat_solve() never probed");
+}
+
+/******************************************************************************
+ * Parallel search
+ ******************************************************************************/
+
+//sat_portfolio_solve() with 1, 2 and 4 threads agrees with the enumeration, and its model
+//satisfies the cnf
+static void check_portfolio(void) {
+  BOOLEAN model[32];
+  for (uint64_t seed = 0; seed < 120; seed++) {
+    c2dSize num_vars = seed % 2 == 0 ? 3 + seed % 12 : 10 + seed % 7;
+    TestCnf cnf = seed % 2 == 0 ? random_cnf(seed, num_vars, num_vars * (1 + seed % 4), 3)
+                                : sized_cnf(seed, num_vars, num_vars * 4 + seed % 8, 3, 3);
+    DimacsCnf* dimacs = test_dimacs(&cnf);
+    BOOLEAN sat = count_models(&cnf, NULL, 0) > 0;
+    for (c2dSize num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      int result = sat_portfolio_solve(dimacs, num_threads, 0, model);
+      CHECK(result == (sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE), "seed %lu, %lu threads: result %d", seed, num_threads, result);
+      if (result == SAT_SATISFIABLE) {
+        CHECK(satisfies(&cnf, model), "seed %lu, %lu threads: the model falsifies the cnf", seed, num_threads);
+      }
+    }
+    dimacs_free(dimacs);
+    free(cnf.lits);
+  }
+}
+
+//returns the models of the cnf as the bits of assignment_of(), and sets *num_models
+static c2dSize* list_models(const TestCnf* cnf, c2dSize* num_models) {
+  BOOLEAN* assignment = malloc(sizeof(BOOLEAN) * (cnf->num_vars + 1));
+  c2dSize* models = malloc(sizeof(c2dSize) * (((c2dSize)1 << cnf->num_vars) + 1));
+  *num_models = 0;
+  for (c2dSize bits = 0; bits < ((c2dSize)1 << cnf->num_vars); bits++) {
+    assignment_of(bits, cnf->num_vars, assignment);
+    if (satisfies(cnf, assignment)) models[(*num_models)++] = bits;
+  }
+  free(assignment);
+  return models;
+}
+
+//returns 1 if every model satisfies the clause, given by its literal codes
+static BOOLEAN implied_clause(const c2dSize* models, c2dSize num_models, const c2dLitCode* codes, c2dSize size) {
+  for (c2dSize m = 0; m < num_models; m++) {
+    BOOLEAN satisfied = 0;
+    for (c2dSize i = 0; i < size && !satisfied; i++) {
+      satisfied = ((models[m] >> ((codes[i] >> 1) - 1)) & 1) == !(codes[i] & 1);
+    }
+    if (!satisfied) return 0;
+  }
+  return 1;
+}
+
+//returns the number of clauses of the ring which are not implied
+static c2dSize unimplied_exports(const c2dSize* models, c2dSize num_models, const ExchangeRing* ring) {
+  c2dSize count = 0;
+  unsigned long first = ring->head > EXCHANGE_RING_SIZE ? ring->head - EXCHANGE_RING_SIZE : 0;
+  for (unsigned long position = first; position < ring->head; position++) {
+    const ExchangeSlot* slot = &(ring->slots[position % EXCHANGE_RING_SIZE]);
+    count += !implied_clause(models, num_models, slot->lits, slot->size);
+  }
+  return count;
+}
+
+//returns the number of learned clauses and literals fixed at the first decision level of sat
+//state which are not implied
+static c2dSize unimplied_learned(const c2dSize* models, c2dSize num_models, const SatState* sat_state) {
+  c2dSize count = 0;
+  for (c2dSize i = 0; i < sat_state->num_learned_clauses; i++) {
+    const Clause* clause = sat_state->learned_clauses[i];
+    count += !implied_clause(models, num_models, clause->lits, clause->size);
+  }
+  for (c2dLitCode code = 2; code < 2 * (sat_state->num_vars + 1); code++) {
+    if (sat_state->values[code] > 0 && sat_state->levels[code >> 1] == 1) {
+      count += !implied_clause(models, num_models, &code, 1);
+    }
+  }
+  return count;
+}
+
+//two sat states share their learned clauses through a clause exchange: the exported clauses
+//are implied by the cnf, and so is everything the other sat state learns by importing them,
+//including after its reader falls more than a ring behind, and when it has eliminated
+//variables; importing never changes the answers
+static void check_exchange(void) {
+  c2dSize num_imported = 0;
+  c2dSize num_overruns = 0;
+  for (uint64_t seed = 0; seed < 150; seed++) {
+    c2dSize num_vars = 10 + seed % 7;
+    TestCnf cnf = sized_cnf(seed, num_vars, num_vars * 4 + seed % 8, 3, 3);
+    c2dSize num_models;
+    c2dSize* models = list_models(&cnf, &num_models);
+    BOOLEAN sat = num_models > 0;
+    int expected = sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE;
+    ClauseExchange* exchange = clause_exchange_new(2, 16, EXCHANGE_MAX_SIZE);
+    SatState* first = test_state(&cnf);
+    SatState* second = test_state(&cnf);
+    if (seed % 2 == 1) sat_preprocess(second);
+    sat_set_clause_exchange(first, exchange, 0);
+    sat_set_clause_exchange(second, exchange, 1);
+
+    int result = sat_solve(first);
+    CHECK(result == expected, "seed %lu: result %d", seed, result);
+    result = sat_solve(second);
+    CHECK(result == expected, "seed %lu: result %d of the second sat state", seed, result);
+
+    // the learned clauses of the first sat state are exported again, until its ring wraps
+    // around before the second sat state reads it
+    if (seed % 3 == 0 && first->num_learned_clauses > 0) {
+      for (c2dSize i = 0; i < 4 * EXCHANGE_RING_SIZE && exchange->rings[0].head <= EXCHANGE_RING_SIZE + 10; i++) {
+        export_clause(first->learned_clauses[i % first->num_learned_clauses], first);
+      }
+      num_overruns += exchange->rings[0].head > EXCHANGE_RING_SIZE;
+    }
+    CHECK(unimplied_exports(models, num_models, &(exchange->rings[0])) == 0, "seed %lu: an exported clause is not implied", seed);
+    CHECK(unimplied_exports(models, num_models, &(exchange->rings[1])) == 0, "seed %lu: an exported clause of the second sat state is not implied", seed);
+
+    for (int round = 0; round < 2; round++) {
+      SatState* sat_state = round == 0 ? second : first;
+      sat_backtrack_to_level(1, sat_state);
+      BOOLEAN consistent = sat_import_clauses(sat_state);
+      CHECK(consistent || !sat, "seed %lu round %d: a satisfiable cnf is found unsatisfiable", seed, round);
+      CHECK(unimplied_learned(models, num_models, sat_state) == 0, "seed %lu round %d: a learned clause is not implied", seed, round);
+      c2dSize num_eliminated = 0;
+      for (c2dSize i = 0; i < sat_state->num_learned_clauses; i++) {
+        const Clause* clause = sat_state->learned_clauses[i];
+        for (c2dSize j = 0; j < clause->size; j++) num_eliminated += sat_state->eliminated[clause->lits[j] >> 1];
+      }
+      CHECK(num_eliminated == 0, "seed %lu round %d: a learned clause has an eliminated variable", seed, round);
+      num_imported += sat_state->num_imported;
+
+      result = sat_solve(sat_state);
+      CHECK(result == expected, "seed %lu round %d: result %d after importing", seed, round, result);
+      if (result == SAT_SATISFIABLE) {
+        CHECK(satisfies(&cnf, sat_model(sat_state)), "seed %lu round %d: the model falsifies the cnf", seed, round);
+      }
+    }
+    CHECK(second->num_eliminated_vars == 0 || second->num_imported <= first->num_exported,
+          "seed %lu: more clauses imported than exported", seed);
+
+    sat_state_free(first);
+    sat_state_free(second);
+    clause_exchange_free(exchange);
+    free(models);
+    free(cnf.lits);
+  }
+  CHECK(num_imported > 0, "no clause was imported");
+  CHECK(num_overruns > 0, "no ring was overrun");
+}
+
+//the cubes of sat_lookahead_cubes() are all unsatisfiable if and only if the cnf is; then
+//sat_solve_cubes() agrees with the enumeration, its model satisfies the cnf, and the result
+//it records for a cube is the one of solving the cube as assumptions
+static void check_cubes(void) {
+  BOOLEAN model[32];
+  c2dSize num_split = 0;
+  for (uint64_t seed = 0; seed < 120; seed++) {
+    c2dSize num_vars = seed % 2 == 0 ? 3 + seed % 12 : 10 + seed % 7;
+    TestCnf cnf = seed % 2 == 0 ? random_cnf(seed, num_vars, num_vars * (1 + seed % 4), 3)
+                                : sized_cnf(seed, num_vars, num_vars * 4 + seed % 8, 3, 3);
+    DimacsCnf* dimacs = test_dimacs(&cnf);
+    BOOLEAN sat = count_models(&cnf, NULL, 0) > 0;
+    int expected = sat ? SAT_SATISFIABLE : SAT_UNSATISFIABLE;
+
+    SatState* sat_state = test_state(&cnf);
+    CubeSet* cubes = sat_lookahead_cubes(sat_state, 1 + seed % 4);
+    BOOLEAN sat_cube = 0;
+    for (c2dSize i = 0; i < cubes->num_cubes; i++) {
+      sat_cube |= count_models(&cnf, cubes->lits + cubes->starts[i], cubes->starts[i + 1] - cubes->starts[i]) > 0;
+    }
+    CHECK(sat_cube == sat, "seed %lu: %s cubes of a %s cnf", seed, sat_cube ? "satisfiable" : "unsatisfiable",
+          sat ? "satisfiable" : "unsatisfiable");
+    num_split += cubes->num_cubes > 1;
+
+    c2dSize num_threads = (c2dSize)1 << (seed % 3);
+    int result = sat_solve_cubes(dimacs, cubes, num_threads, 0, model);
+    CHECK(result == expected, "seed %lu, %lu threads: result %d", seed, num_threads, result);
+    if (result == SAT_SATISFIABLE) {
+      CHECK(satisfies(&cnf, model), "seed %lu, %lu threads: the model falsifies the cnf", seed, num_threads);
+    }
+
+    // the cubes left unsolved once the answer is known are SAT_UNKNOWN
+    for (c2dSize i = 0; i < cubes->num_cubes; i++) {
+      if (cubes->results[i] == SAT_UNKNOWN) {
+        CHECK(result != SAT_UNKNOWN, "seed %lu: cube %lu was not solved", seed, i);
+        continue;
+      }
+      c2dSize size = cubes->starts[i + 1] - cubes->starts[i];
+      int cube_result = sat_solve_with_assumptions(cubes->lits + cubes->starts[i], size, sat_state);
+      CHECK(cubes->results[i] == cube_result, "seed %lu: cube %lu has result %d, %d as assumptions", seed, i,
+            cubes->results[i], cube_result);
+    }
+
+    cube_set_free(cubes);
+    sat_state_free(sat_state);
+    dimacs_free(dimacs);
+    free(cnf.lits);
+  }
+  CHECK(num_split > 0, "no cnf was split");
+}
+
+/******************************************************************************
+ * Components
+ ******************************************************************************/
+
+//sets the literals instantiated in sat state, and returns their number
+static c2dSize instantiated_literals(const SatState* sat_state, c2dLiteral* lits) {
+  c2dSize size = 0;
+  for (c2dSize v = 1; v <= sat_state->num_vars; v++) {
+    if (sat_state->values[2 * v] != 0) lits[size++] = sat_state->values[2 * v] > 0 ? (c2dLiteral)v : -(c2dLiteral)v;
+  }
+  return size;
+}
+
+//returns the number of assignments of the free variables among vars which, with the current
+//assignment of sat state, satisfy the given cnf clauses
+static c2dSize count_residual(const SatState* sat_state, const c2dSize* vars, c2dSize num_vars,
+                              const c2dSize* clauses, c2dSize num_clauses) {
+  BOOLEAN* values = malloc(sizeof(BOOLEAN) * (sat_state->num_vars + 1));
+  for (c2dSize v = 1; v <= sat_state->num_vars; v++) values[v] = sat_state->values[2 * v];
+  c2dSize* free_vars = malloc(sizeof(c2dSize) * (num_vars + 1));
+  c2dSize num_free = 0;
+  for (c2dSize i = 0; i < num_vars; i++) {
+    if (values[vars[i]] == 0) free_vars[num_free++] = vars[i];
+  }
+  c2dSize count = 0;
+  for (c2dSize bits = 0; bits < ((c2dSize)1 << num_free); bits++) {
+    for (c2dSize i = 0; i < num_free; i++) values[free_vars[i]] = (bits >> i) & 1 ? 1 : -1;
+    BOOLEAN sat = 1;
+    for (c2dSize i = 0; i < num_clauses && sat; i++) {
+      const Clause* clause = sat_index2clause(clauses[i], sat_state);
+      Lit** lits = sat_clause_literals(clause);
+      BOOLEAN satisfied = 0;
+      for (c2dSize j = 0; j < sat_clause_size(clause); j++) {
+        c2dLiteral lit = sat_literal_index(lits[j]);
+        satisfied |= values[lit > 0 ? lit : -lit] == (lit > 0 ? 1 : -1);
+      }
+      sat = satisfied;
+    }
+    if (sat) ++count;
+  }
+  free(free_vars);
+  free(values);
+  return count;
+}
+
+//the components of the last frame share no variable, cover the free variables of scope (by
+//variable, 1 if it is in the scope), and their counts multiply to count
+static void check_frame(uint64_t seed, const SatState* sat_state, const ComponentStack* stack,
+                        const BOOLEAN* scope, c2dSize count) {
+  c2dSize* owners = calloc(sat_state->num_vars + 1, sizeof(c2dSize));
+  c2dSize first;
+  c2dSize num_components = component_stack_top(stack, &first);
+  c2dSize product = 1;
+  for (c2dSize c = first; c < first + num_components; c++) {
+    c2dSize num_vars, num_clauses;
+    const c2dSize* vars = component_vars(stack, c, &num_vars);
+    const c2dSize* clauses = component_clauses(stack, c, &num_clauses);
+    CHECK(num_vars > 0, "seed %lu: component %lu has no variable", seed, c);
+    for (c2dSize i = 0; i < num_vars; i++) {
+      c2dSize var = vars[i];
+      CHECK(scope[var] && sat_state->values[2 * var] == 0, "seed %lu: variable %lu is not free in the scope", seed, var);
+      CHECK(owners[var] == 0, "seed %lu: variable %lu is in two components", seed, var);
+      owners[var] = c + 1;
+    }
+    for (c2dSize i = 0; i < num_clauses; i++) {
+      const Clause* clause = sat_index2clause(clauses[i], sat_state);
+      CHECK(!sat_subsumed_clause(clause), "seed %lu: clause %lu is subsumed", seed, clauses[i]);
+      Lit** lits = sat_clause_literals(clause);
+      for (c2dSize j = 0; j < sat_clause_size(clause); j++) {
+        c2dSize var = sat_var_index(sat_literal_var(lits[j]));
+        CHECK(sat_state->values[2 * var] != 0 || owners[var] == c + 1,
+              "seed %lu: clause %lu has a free variable outside of its component", seed, clauses[i]);
+      }
+    }
+    product *= count_residual(sat_state, vars, num_vars, clauses, num_clauses);
+  }
+  for (c2dSize v = 1; v <= sat_state->num_vars; v++) {
+    if (scope[v] && sat_state->values[2 * v] == 0) CHECK(owners[v] != 0, "seed %lu: variable %lu is in no component", seed, v);
+  }
+  CHECK(product == count, "seed %lu: the components count %lu models, not %lu", seed, product, count);
+  free(owners);
+}
+
+//the frames pushed by sat_components(), and by sat_split_component() after more decisions,
+//partition the free variables and the clauses which are not subsumed, so that the counts of
+//the components multiply to the count of the whole; with and without subsumption tracking
+static void check_components(void) {
+  c2dLiteral lits[16];
+  c2dSize parent_vars[16];
+  for (uint64_t seed = 0; seed < 300; seed++) {
+    c2dSize num_vars = 3 + seed % 12;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 3) / 2 + 1, 3);
+    SatState* sat_state = test_state(&cnf);
+    sat_set_subsumption_tracking(sat_state, seed % 2);
+    if (!sat_unit_resolution(sat_state)) {
+      sat_state_free(sat_state);
+      free(cnf.lits);
+      continue;
+    }
+    c2dSize* parent_clauses = malloc(sizeof(c2dSize) * cnf.num_clauses);
+
+    BOOLEAN* scope = malloc(sizeof(BOOLEAN) * (num_vars + 1));
+    for (c2dSize v = 1; v <= num_vars; v++) scope[v] = 1;
+    ComponentStack* stack = component_stack_new(sat_state);
+    sat_components(sat_state, stack);
+    c2dSize num_lits = instantiated_literals(sat_state, lits);
+    check_frame(seed, sat_state, stack, scope, count_models(&cnf, lits, num_lits));
+
+    // decides a variable of the largest component, then splits the component
+    c2dSize num_decisions = 0, num_splits = 0;
+    for (;;) {
+      c2dSize first, parent = 0, num_parent_vars = 0, num_parent_clauses;
+      c2dSize num_components = component_stack_top(stack, &first);
+      for (c2dSize c = first; c < first + num_components; c++) {
+        c2dSize size;
+        component_vars(stack, c, &size);
+        if (size > num_parent_vars) {
+          parent = c;
+          num_parent_vars = size;
+        }
+      }
+      if (num_parent_vars < 2) break;
+      const c2dSize* vars = component_vars(stack, parent, &num_parent_vars);
+      memcpy(parent_vars, vars, sizeof(c2dSize) * num_parent_vars);
+      const c2dSize* clauses = component_clauses(stack, parent, &num_parent_clauses);
+      memcpy(parent_clauses, clauses, sizeof(c2dSize) * num_parent_clauses);
+
+      c2dSize var = parent_vars[random_below(num_parent_vars)];
+      Var* decided = sat_index2var(var, sat_state);
+      ++num_decisions;
+      if (sat_decide_literal(random_below(2) ? sat_pos_literal(decided) : sat_neg_literal(decided), sat_state) != NULL) {
+        break;
+      }
+      for (c2dSize v = 1; v <= num_vars; v++) scope[v] = 0;
+      for (c2dSize i = 0; i < num_parent_vars; i++) scope[parent_vars[i]] = 1;
+      sat_split_component(parent, sat_state, stack);
+      ++num_splits;
+      check_frame(seed, sat_state, stack, scope,
+                  count_residual(sat_state, parent_vars, num_parent_vars, parent_clauses, num_parent_clauses));
+    }
+    while (num_splits-- > 0) component_stack_pop(stack);
+    while (num_decisions-- > 0) sat_undo_decide_literal(sat_state);
+
+    // the first frame is found again once the decisions are undone
+    component_stack_pop(stack);
+    sat_components(sat_state, stack);
+    for (c2dSize v = 1; v <= num_vars; v++) scope[v] = 1;
+    check_frame(seed, sat_state, stack, scope, count_models(&cnf, lits, num_lits));
+
+    free(parent_clauses);
+    free(scope);
+    component_stack_free(stack);
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+}
+
+/******************************************************************************
+ * Component cache
+ ******************************************************************************/
+
+//looks up the component with variable i and clause i, returns 1 on a hit
+static BOOLEAN lookup_single(ComponentCache* cache, c2dSize i, c2dWmc* count) {
+  return component_cache_lookup(cache, &i, 1, &i, 1, count);
+}
+
+static void store_single(ComponentCache* cache, c2dSize i) {
+  component_cache_store(cache, &i, 1, &i, 1, (c2dWmc)i);
+}
+
+//returns the count of the component (of the last frame of the stack) under the current
+//assignment of sat state, deciding its variables and splitting it, and caching the counts
+static c2dWmc count_component(SatState* sat_state, ComponentStack* stack, ComponentCache* cache, c2dSize component) {
+  c2dSize num_vars, num_clauses;
+  const c2dSize* vars = component_vars(stack, component, &num_vars);
+  const c2dSize* clauses = component_clauses(stack, component, &num_clauses);
+  if (num_clauses == 0) return (c2dWmc)((c2dSize)1 << num_vars);
+  c2dWmc count;
+  if (component_cache_lookup(cache, vars, num_vars, clauses, num_clauses, &count)) return count;
+
+  Var* var = sat_index2var(vars[0], sat_state);
+  count = 0;
+  for (int positive = 1; positive >= 0; positive--) {
+    if (sat_decide_literal(positive ? sat_pos_literal(var) : sat_neg_literal(var), sat_state) == NULL) {
+      c2dSize first;
+      c2dSize num_components = sat_split_component(component, sat_state, stack);
+      component_stack_top(stack, &first);
+      c2dWmc product = 1;
+      for (c2dSize c = first; c < first + num_components; c++) product *= count_component(sat_state, stack, cache, c);
+      component_stack_pop(stack);
+      count += product;
+    }
+    sat_undo_decide_literal(sat_state);
+  }
+
+  vars = component_vars(stack, component, &num_vars);
+  clauses = component_clauses(stack, component, &num_clauses);
+  component_cache_store(cache, vars, num_vars, clauses, num_clauses, count);
+  return count;
+}
+
+//a cache of 200 bytes keeps a couple of entries: it stays within its budget, evicts the least
+//recently used entry, does not store an entry larger than the budget, and forgets the stores
+//made since a mark; a counter using it still agrees with the enumeration
+static void check_cache(void) {
+  c2dWmc count;
+  ComponentCache* cache = component_cache_new(200, CACHE_COUNTS);
+  c2dSize capacity = 0;
+  for (c2dSize i = 1; i <= 50; i++) {
+    store_single(cache, i);
+    CHECK(cache->bytes <= 200, "the cache takes %lu bytes", cache->bytes);
+    CHECK(lookup_single(cache, i, &count) && count == (c2dWmc)i, "entry %lu is not found after its store", i);
+    if (cache->num_evictions == 0) capacity = i;
+  }
+  CHECK(capacity >= 1 && capacity < 50, "the cache keeps %lu entries", capacity);
+  CHECK(!lookup_single(cache, 1, &count), "the first entry is not evicted");
+  component_cache_free(cache);
+
+  // a lookup makes the entry the most recently used one
+  cache = component_cache_new(200, CACHE_COUNTS);
+  for (c2dSize i = 1; i <= capacity; i++) store_single(cache, i);
+  CHECK(lookup_single(cache, 1, &count), "entry 1 is evicted too early");
+  store_single(cache, capacity + 1);
+  CHECK(lookup_single(cache, 1, &count), "the entry looked up last is evicted");
+  CHECK(capacity == 1 || !lookup_single(cache, 2, &count), "the least recently used entry is kept");
+
+  // entries stored or updated since the mark are forgotten, older ones are kept
+  c2dSize kept = capacity + 1;
+  lookup_single(cache, kept, &count);
+  c2dSize mark = component_cache_mark(cache);
+  store_single(cache, 1000);
+  component_cache_forget(cache, mark);
+  CHECK(!lookup_single(cache, 1000, &count), "a store after the mark is not forgotten");
+  CHECK(capacity == 1 || lookup_single(cache, kept, &count), "a store before the mark is forgotten");
+  mark = component_cache_mark(cache);
+  store_single(cache, kept);
+  component_cache_forget(cache, mark);
+  CHECK(!lookup_single(cache, kept, &count), "an update after the mark is not forgotten");
+
+  c2dSize large[100];
+  for (c2dSize i = 0; i < 100; i++) large[i] = 1000 * (i + 1);
+  component_cache_store(cache, large, 100, large, 100, 1);
+  CHECK(!component_cache_lookup(cache, large, 100, large, 100, &count), "an entry larger than the budget is stored");
+  CHECK(cache->bytes <= 200, "the cache takes %lu bytes", cache->bytes);
+  component_cache_free(cache);
+
+  for (uint64_t seed = 0; seed < 200; seed++) {
+    c2dSize num_vars = 3 + seed % 12;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 3) / 2 + 1, 3);
+    SatState* sat_state = test_state(&cnf);
+    sat_set_subsumption_tracking(sat_state, seed % 2);
+    c2dSize expected = count_models(&cnf, NULL, 0);
+    BOOLEAN consistent = sat_unit_resolution(sat_state);
+    for (int large_budget = 0; large_budget < 2; large_budget++) {
+      cache = component_cache_new(large_budget ? 1 << 20 : 200, CACHE_COUNTS);
+      ComponentStack* stack = component_stack_new(sat_state);
+      count = 0;
+      if (consistent) {
+        c2dSize first;
+        c2dSize num_components = sat_components(sat_state, stack);
+        component_stack_top(stack, &first);
+        count = 1;
+        for (c2dSize c = first; c < first + num_components; c++) count *= count_component(sat_state, stack, cache, c);
+        component_stack_pop(stack);
+      }
+      CHECK(count == (c2dWmc)expected, "seed %lu budget %s: %.0f models, not %lu", seed,
+            large_budget ? "1MB" : "200B", (double)count, expected);
+      component_stack_free(stack);
+      component_cache_free(cache);
+    }
+    sat_state_free(sat_state);
+    free(cnf.lits);
+  }
+}
+
+/******************************************************************************
+ * Weights
+ ******************************************************************************/
+
+//returns the weighted model count of the cnf given the weights of the literals (by code)
+static double weighted_count(const TestCnf* cnf, const double* weights) {
+  BOOLEAN* assignment = malloc(sizeof(BOOLEAN) * (cnf->num_vars + 1));
+  double count = 0;
+  for (c2dSize bits = 0; bits < ((c2dSize)1 << cnf->num_vars); bits++) {
+    assignment_of(bits, cnf->num_vars, assignment);
+    if (!satisfies(cnf, assignment)) continue;
+    double product = 1;
+    for (c2dSize v = 1; v <= cnf->num_vars; v++) product *= weights[assignment[v] > 0 ? 2 * v : 2 * v + 1];
+    count += product;
+  }
+  free(assignment);
+  return count;
+}
+
+//returns 1 if a and b are equal up to a relative error of 1e-9
+static BOOLEAN close_to(double a, double b) {
+  return fabs(a - b) <= 1e-9 * fmax(fabs(a), fabs(b));
+}
+
+//returns a weighted cnf in DIMACS format, and sets the weights it gives (by literal code);
+//every variable gets weights from one of the weight line formats, placed before the header,
+//among the clauses or after them
+static char* weighted_text(const TestCnf* cnf, double* weights, c2dSize* len) {
+  char* text = malloc(128 + 64 * (cnf->num_lits + 4 * cnf->num_vars));
+  char* lines[3] = {malloc(64 * 4 * cnf->num_vars + 1), malloc(64 * 4 * cnf->num_vars + 1), malloc(64 * 4 * cnf->num_vars + 1)};
+  c2dSize sizes[3] = {0, 0, 0};
+  for (c2dSize i = 0; i < 2 * (cnf->num_vars + 1); i++) weights[i] = 1;
+  for (c2dSize v = 1; v <= cnf->num_vars; v++) {
+    c2dSize where = random_below(3);
+    char* line = lines[where] + sizes[where];
+    double weight = (double)(1 + random_below(15)) / 8;
+    switch (random_below(5)) {
+      case 0:  // both literals, comment format
+        weights[2 * v] = weight;
+        weights[2 * v + 1] = (double)(1 + random_below(15)) / 8;
+        sizes[where] += (c2dSize)sprintf(line, "c p weight %lu %g 0\nc p weight -%lu %g 0\n", v, weights[2 * v], v,
+                                         weights[2 * v + 1]);
+        break;
+      case 1:  // a positive literal, cachet format: its negation gets 1 - weight
+        weight = (double)(1 + random_below(7)) / 8;
+        weights[2 * v] = weight;
+        weights[2 * v + 1] = 1 - weight;
+        sizes[where] += (c2dSize)sprintf(line, "w %lu %g\n", v, weight);
+        break;
+      case 2:  // both literals get 1
+        sizes[where] += (c2dSize)sprintf(line, "w %lu -1\n", v);
+        break;
+      case 3:  // a negative literal, cachet format: only the literal itself
+        weights[2 * v + 1] = weight;
+        sizes[where] += (c2dSize)sprintf(line, "w -%lu %g\n", v, weight);
+        break;
+      default:  // no weight line
+        break;
+    }
+  }
+
+  c2dSize n = 0;
+  memcpy(text + n, lines[0], sizes[0]);
+  n += sizes[0];
+  n += (c2dSize)sprintf(text + n, "p cnf %lu %lu\n", cnf->num_vars, cnf->num_clauses);
+  for (c2dSize i = 0; i < cnf->num_lits; i++) {
+    n += (c2dSize)sprintf(text + n, cnf->lits[i] == 0 ? "0\n" : "%ld ", cnf->lits[i]);
+    if (i == cnf->num_lits / 2) {
+      // weight lines cut a clause only between two of its literals
+      while (cnf->lits[i] != 0 && i + 1 < cnf->num_lits) {
+        ++i;
+        n += (c2dSize)sprintf(text + n, cnf->lits[i] == 0 ? "0\n" : "%ld ", cnf->lits[i]);
+      }
+      memcpy(text + n, lines[1], sizes[1]);
+      n += sizes[1];
+    }
+  }
+  memcpy(text + n, lines[2], sizes[2]);
+  n += sizes[2];
+  for (int i = 0; i < 3; i++) free(lines[i]);
+  *len = n;
+  return text;
+}
+
+//weight lines are parsed wherever they are, each literal weight is a single lookup, and the
+//weighted model count combined with the wmc functions agrees with the one of the
+//enumeration; counts beyond a double are kept in the long double and log modes
+static void check_weights(void) {
+  for (uint64_t seed = 0; seed < 200; seed++) {
+    c2dSize num_vars = 3 + seed % 10;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 3) / 2 + 1, 3);
+    double* weights = malloc(sizeof(double) * 2 * (num_vars + 1));
+    c2dSize len;
+    char* text = weighted_text(&cnf, weights, &len);
+    DimacsCnf* dimacs = dimacs_parse(text, len);
+    free(text);
+    CHECK(dimacs != NULL, "seed %lu: the weighted cnf is rejected", seed);
+    if (dimacs == NULL) {
+      free(weights);
+      free(cnf.lits);
+      continue;
+    }
+    SatState* sat_state = sat_state_new_from_cnf(dimacs);
+    for (c2dSize v = 1; v <= num_vars; v++) {
+      Var* var = sat_index2var(v, sat_state);
+      CHECK(dimacs->weights == NULL || (dimacs->weights[2 * v] == weights[2 * v] && dimacs->weights[2 * v + 1] == weights[2 * v + 1]),
+            "seed %lu: the parsed weights of %lu are wrong", seed, v);
+      CHECK(sat_literal_weight(sat_pos_literal(var)) == wmc_from_weight(weights[2 * v]) &&
+            sat_literal_weight(sat_neg_literal(var)) == wmc_from_weight(weights[2 * v + 1]),
+            "seed %lu: the weights of %lu are wrong", seed, v);
+    }
+
+    BOOLEAN* assignment = malloc(sizeof(BOOLEAN) * (num_vars + 1));
+    c2dWmc count = wmc_zero();
+    for (c2dSize bits = 0; bits < ((c2dSize)1 << num_vars); bits++) {
+      assignment_of(bits, num_vars, assignment);
+      if (!satisfies(&cnf, assignment)) continue;
+      c2dWmc product = wmc_one();
+      for (c2dSize v = 1; v <= num_vars; v++) {
+        Var* var = sat_index2var(v, sat_state);
+        product = wmc_mul(product, sat_literal_weight(assignment[v] > 0 ? sat_pos_literal(var) : sat_neg_literal(var)));
+      }
+      count = wmc_add(count, product);
+    }
+    double expected = weighted_count(&cnf, weights);
+    CHECK(close_to(wmc_value(count), expected), "seed %lu: weighted count %g, not %g", seed, wmc_value(count), expected);
+
+    free(assignment);
+    sat_state_free(sat_state);
+    dimacs_free(dimacs);
+    free(weights);
+    free(cnf.lits);
+  }
+
+  const char* invalid[2] = {"w 4 0.5\np cnf 3 1\n1 2 3 0\n", "p cnf 3 1\nc p weight -4 0.5 0\n1 2 3 0\n"};
+  for (int i = 0; i < 2; i++) {
+    DimacsCnf* dimacs = dimacs_parse(invalid[i], strlen(invalid[i]));
+    CHECK(dimacs == NULL, "the weight of a literal beyond the cnf is accepted");
+    if (dimacs != NULL) dimacs_free(dimacs);
+  }
+
+  // 2^20000 overflows a double, but not a long double or its logarithm
+  c2dWmc count = wmc_one();
+  for (int i = 0; i < 20000; i++) count = wmc_mul(count, wmc_from_weight(2));
+  CHECK(wmc_value(count) == HUGE_VAL, "2^20000 fits in a double");
+#if defined(SAT_WMC_LONG) || defined(SAT_WMC_LOG)
+  CHECK(close_to(wmc_log(count), 20000 * log(2)), "the logarithm of 2^20000 is %g", wmc_log(count));
+#endif
+}
+
+/******************************************************************************
+ * Parsing
+ ******************************************************************************/
+
+#define NUM_ROUTES 5
+
+static const char* route_names[NUM_ROUTES] = {"buffer", "file", "pipe", "gzip file", "gzip pipe"};
+
+//returns the text parsed from a buffer (route 0), a file (1), a pipe (2), or compressed by gzip
+//from a file (3) or a pipe (4), NULL if it is rejected
+static DimacsCnf* parse_through(const char* text, c2dSize len, int route) {
+  if (route == 0) return dimacs_parse(text, len);
+  char path[] = "/tmp/sat_check_XXXXXX";
+  char command[128];
+  int fd = mkstemp(path);
+  if (fd < 0) return NULL;
+  BOOLEAN written = write(fd, text, len) == (ssize_t)len;
+  close(fd);
+
+  DimacsCnf* cnf = NULL;
+  if (written && route == 1) cnf = dimacs_read_file(path);
+  if (written && (route == 2 || route == 4)) {
+    sprintf(command, route == 2 ? "cat %s" : "gzip -c %s", path);
+    FILE* pipe = popen(command, "r");
+    if (pipe != NULL) {
+      cnf = dimacs_read_fd(fileno(pipe));
+      pclose(pipe);
+    }
+  }
+  if (written && route == 3) {
+    sprintf(command, "gzip -c %s > %s.gz", path, path);
+    if (system(command) == 0) {
+      sprintf(command, "%s.gz", path);
+      cnf = dimacs_read_file(command);
+      unlink(command);
+    }
+  }
+  unlink(path);
+  return cnf;
+}
+
+//returns 1 if the parsed cnf has the clauses of the cnf, in the same order
+static BOOLEAN same_clauses(const DimacsCnf* dimacs, const TestCnf* cnf) {
+  if (dimacs->num_vars != cnf->num_vars || dimacs->num_clauses != cnf->num_clauses) return 0;
+  if (dimacs->num_codes != cnf->num_lits) return 0;
+  for (c2dSize i = 0; i < cnf->num_lits; i++) {
+    c2dLiteral lit = cnf->lits[i];
+    if (dimacs->codes[i] != (lit == 0 ? 0 : lit > 0 ? 2 * (c2dLitCode)lit : 2 * (c2dLitCode)-lit + 1)) return 0;
+  }
+  return 1;
+}
+
+//returns the cnf in DIMACS format on two lines, the header and then all the clauses, with
+//pad spaces after each literal; the last clause misses its 0
+static char* one_line_text(const TestCnf* cnf, c2dSize pad, c2dSize* len) {
+  char* text = malloc(64 + (24 + pad) * (cnf->num_lits + 1));
+  c2dSize n = (c2dSize)sprintf(text, "p cnf %lu %lu\n", cnf->num_vars, cnf->num_clauses);
+  for (c2dSize i = 0; i + 1 < cnf->num_lits; i++) {
+    n += (c2dSize)sprintf(text + n, "%ld", cnf->lits[i]);
+    memset(text + n, ' ', pad);
+    n += pad;
+  }
+  text[n++] = '\n';
+  *len = n;
+  return text;
+}
+
+//returns the cnf in DIMACS format with a comment line after each clause, and a comment line
+//and a blank line cutting one clause; the last clause misses its 0 and its newline
+static char* commented_text(const TestCnf* cnf, c2dSize* len) {
+  char* text = malloc(128 + 48 * (cnf->num_lits + cnf->num_clauses + 1));
+  c2dSize n = (c2dSize)sprintf(text, "c a comment before the header\np cnf %lu %lu\n", cnf->num_vars, cnf->num_clauses);
+  c2dSize clause = 0;
+  for (c2dSize i = 0; i + 1 < cnf->num_lits; i++) {
+    if (cnf->lits[i] != 0) n += (c2dSize)sprintf(text + n, "%ld ", cnf->lits[i]);
+    else n += (c2dSize)sprintf(text + n, "0\nc clause %lu, with 0 1 2 in a comment\n", ++clause);
+    if (i == cnf->num_lits / 2 && cnf->lits[i] != 0) n += (c2dSize)sprintf(text + n, "\nc inside a clause\n\n");
+  }
+  *len = n;
+  return text;
+}
+
+//the parser reads the same clauses and weights from a buffer, a file, a pipe (through
+//dimacs_read_fd()) and gzip input, with lines longer than the buffer of the former parser
+//(32768 bytes) and than a stream chunk, comments in the middle of the clauses, a last clause
+//without its 0, and weight lines before, in the middle of and after the clauses
+static void check_parse(void) {
+  for (uint64_t seed = 0; seed < 40; seed++) {
+    c2dSize num_vars = 3 + seed % 10;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (1 + seed % 3) + 1, 3);
+    char* texts[3];
+    c2dSize lens[3];
+    // a line of 40000 bytes, or of 3MB for a few seeds
+    texts[0] = one_line_text(&cnf, (seed % 10 == 0 ? 3 << 20 : 40000) / cnf.num_lits + 1, &lens[0]);
+    texts[1] = commented_text(&cnf, &lens[1]);
+    // "c t wmc" announces the weight lines, which a stream then reads after the last clause too
+    double* weights = malloc(sizeof(double) * 2 * (num_vars + 1));
+    char* weighted = weighted_text(&cnf, weights, &lens[2]);
+    texts[2] = malloc(lens[2] + 8);
+    memcpy(texts[2], "c t wmc\n", 8);
+    memcpy(texts[2] + 8, weighted, lens[2]);
+    lens[2] += 8;
+    free(weighted);
+
+    for (int t = 0; t < 3; t++) {
+      for (int route = 0; route < NUM_ROUTES; route++) {
+        DimacsCnf* dimacs = parse_through(texts[t], lens[t], route);
+        CHECK(dimacs != NULL, "seed %lu text %d: rejected through the %s", seed, t, route_names[route]);
+        if (dimacs == NULL) continue;
+        CHECK(same_clauses(dimacs, &cnf), "seed %lu text %d: wrong clauses through the %s", seed, t, route_names[route]);
+        for (c2dSize code = 2; code < 2 * (num_vars + 1) && t == 2; code++) {
+          double weight = dimacs->weights == NULL ? 1 : dimacs->weights[code];
+          CHECK(weight == weights[code], "seed %lu: wrong weight of literal code %lu through the %s", seed, code, route_names[route]);
+        }
+        dimacs_free(dimacs);
+      }
+    }
+
+    for (int t = 0; t < 3; t++) free(texts[t]);
+    free(weights);
+    free(cnf.lits);
+  }
+}
+
+/******************************************************************************
+ * Compilation
+ ******************************************************************************/
+
+//returns the value of the root of the circuit under the assignment, and sets the values of
+//its nodes; returns -1 if an or node has two true children
+static int evaluate(const NnfCircuit* circuit, const BOOLEAN* assignment, BOOLEAN* values) {
+  for (c2dSize n = 0; n <= circuit->root; n++) {
+    const NnfNode* node = &(circuit->nodes[n]);
+    const c2dSize* children = circuit->children + node->children;
+    if (node->kind == NNF_LITERAL) {
+      c2dLiteral lit = node->literal;
+      values[n] = assignment[lit > 0 ? lit : -lit] == (lit > 0 ? 1 : -1);
+    } else if (node->kind == NNF_AND) {
+      values[n] = 1;
+      for (c2dSize i = 0; i < node->num_children; i++) values[n] &= values[children[i]];
+    } else {
+      c2dSize num_true = 0;
+      for (c2dSize i = 0; i < node->num_children; i++) num_true += values[children[i]];
+      if (num_true > 1) return -1;
+      values[n] = num_true == 1;
+    }
+  }
+  return values[circuit->root];
+}
+
+//returns the circuit read back from the file written by nnf_write(), NULL if it cannot be read
+static NnfCircuit* read_circuit(const char* file_name) {
+  FILE* file = fopen(file_name, "r");
+  if (file == NULL) return NULL;
+  c2dSize num_nodes, num_edges, num_vars;
+  if (fscanf(file, "nnf %lu %lu %lu", &num_nodes, &num_edges, &num_vars) != 3) {
+    fclose(file);
+    return NULL;
+  }
+  NnfCircuit* circuit = nnf_circuit_new(num_vars);
+  c2dSize* ids = malloc(sizeof(c2dSize) * (num_nodes + 1));
+  c2dSize* children = malloc(sizeof(c2dSize) * (num_edges + 1));
+  BOOLEAN ok = 1;
+  for (c2dSize n = 0; n < num_nodes && ok; n++) {
+    char kind;
+    c2dLiteral literal = 0;
+    c2dSize num_children = 0;
+    ok = fscanf(file, " %c", &kind) == 1;
+    if (ok && kind == 'L') ok = fscanf(file, "%ld", &literal) == 1;
+    else if (ok && kind == 'A') ok = fscanf(file, "%lu", &num_children) == 1;
+    else if (ok) ok = kind == 'O' && fscanf(file, "%ld %lu", &literal, &num_children) == 2;
+    for (c2dSize i = 0; i < num_children && ok; i++) {
+      c2dSize child;
+      ok = fscanf(file, "%lu", &child) == 1 && child < n;
+      if (ok) children[i] = ids[child];
+    }
+    if (!ok) break;
+    if (kind == 'L') ids[n] = nnf_literal(circuit, literal);
+    else if (kind == 'A') ids[n] = nnf_and(circuit, children, num_children);
+    else if (num_children == 0) ids[n] = NNF_FALSE;
+    else ok = num_children == 2 && (ids[n] = nnf_decision(circuit, (c2dSize)literal, children[0], children[1]), 1);
+  }
+  circuit->root = num_nodes > 0 ? ids[num_nodes - 1] : NNF_FALSE;
+  free(ids);
+  free(children);
+  fclose(file);
+  if (!ok || num_nodes == 0) {
+    nnf_circuit_free(circuit);
+    return NULL;
+  }
+  return circuit;
+}
+
+//returns the weighted model count of the circuit over all the variables, the weights given by
+//the literals of sat state; vars[n] is set to the variables below node n, as a bit set
+static c2dWmc circuit_count(const NnfCircuit* circuit, const SatState* sat_state, c2dSize* vars) {
+  c2dSize num_vars = sat_state->num_vars;
+  c2dWmc* sums = malloc(sizeof(c2dWmc) * (num_vars + 1));
+  for (c2dSize v = 1; v <= num_vars; v++) {
+    Var* var = sat_index2var(v, sat_state);
+    sums[v] = wmc_add(sat_literal_weight(sat_pos_literal(var)), sat_literal_weight(sat_neg_literal(var)));
+  }
+  c2dWmc* counts = malloc(sizeof(c2dWmc) * (circuit->root + 1));
+  for (c2dSize n = 0; n <= circuit->root; n++) {
+    const NnfNode* node = &(circuit->nodes[n]);
+    const c2dSize* children = circuit->children + node->children;
+    if (node->kind == NNF_LITERAL) {
+      c2dLiteral lit = node->literal;
+      vars[n] = (c2dSize)1 << (lit > 0 ? lit : -lit);
+      counts[n] = sat_literal_weight(sat_index2literal(lit, sat_state));
+      continue;
+    }
+    vars[n] = 0;
+    for (c2dSize i = 0; i < node->num_children; i++) vars[n] |= vars[children[i]];
+    counts[n] = node->kind == NNF_AND ? wmc_one() : wmc_zero();
+    for (c2dSize i = 0; i < node->num_children; i++) {
+      if (node->kind == NNF_AND) {
+        counts[n] = wmc_mul(counts[n], counts[children[i]]);
+        continue;
+      }
+      // the variables below the or node but not below the child take any value
+      c2dWmc count = counts[children[i]];
+      for (c2dSize v = 1; v <= num_vars; v++) {
+        if ((vars[n] >> v & 1) && !(vars[children[i]] >> v & 1)) count = wmc_mul(count, sums[v]);
+      }
+      counts[n] = wmc_add(counts[n], count);
+    }
+  }
+  c2dWmc count = counts[circuit->root];
+  for (c2dSize v = 1; v <= num_vars; v++) {
+    if (!(vars[circuit->root] >> v & 1)) count = wmc_mul(count, sums[v]);
+  }
+  free(counts);
+  free(sums);
+  return count;
+}
+
+//checks the circuit compiled from the cnf: it is decomposable, deterministic, its nodes are
+//unique, it is true exactly on the models of the cnf, and its weighted model count is the
+//one of the enumeration
+static void check_circuit(uint64_t seed, const char* run, const NnfCircuit* circuit, const TestCnf* cnf,
+                          const SatState* sat_state, const double* weights) {
+  c2dSize* vars = malloc(sizeof(c2dSize) * (circuit->root + 1));
+  c2dWmc count = circuit_count(circuit, sat_state, vars);
+  double expected = weighted_count(cnf, weights);
+  CHECK(close_to(wmc_value(count), expected), "seed %lu %s: the circuit counts %g, not %g", seed, run,
+        wmc_value(count), expected);
+
+  for (c2dSize n = 0; n <= circuit->root; n++) {
+    const NnfNode* node = &(circuit->nodes[n]);
+    const c2dSize* children = circuit->children + node->children;
+    c2dSize seen = 0;
+    for (c2dSize i = 0; i < node->num_children && node->kind == NNF_AND; i++) {
+      CHECK((seen & vars[children[i]]) == 0, "seed %lu %s: and node %lu is not decomposable", seed, run, n);
+      seen |= vars[children[i]];
+    }
+    c2dSize equal = n;
+    for (c2dSize m = 0; m < n && equal == n; m++) {
+      const NnfNode* other = &(circuit->nodes[m]);
+      if (other->kind == node->kind && other->literal == node->literal && other->num_children == node->num_children &&
+          (node->num_children == 0 ||
+           memcmp(circuit->children + other->children, children, sizeof(c2dSize) * node->num_children) == 0)) {
+        equal = m;
+      }
+    }
+    CHECK(equal == n, "seed %lu %s: nodes %lu and %lu are equal", seed, run, equal, n);
+  }
+
+  BOOLEAN* assignment = malloc(sizeof(BOOLEAN) * (cnf->num_vars + 1));
+  BOOLEAN* values = malloc(sizeof(BOOLEAN) * (circuit->root + 1));
+  c2dSize bits = 0;
+  int value = 0;
+  for (; bits < ((c2dSize)1 << cnf->num_vars); bits++) {
+    assignment_of(bits, cnf->num_vars, assignment);
+    value = evaluate(circuit, assignment, values);
+    if (value != satisfies(cnf, assignment)) break;
+  }
+  CHECK(bits == ((c2dSize)1 << cnf->num_vars), "seed %lu %s: the circuit is %d on assignment %lu (-1: not deterministic)",
+        seed, run, value, bits);
+  free(values);
+  free(assignment);
+  free(vars);
+}
+
+//sat_compile() gives a circuit equivalent to the cnf, with and without subsumption tracking and
+//with a cache of 200 bytes or 1MB; the circuit written by nnf_write() and read back is too
+static void check_compile(void) {
+  const char* file_name = "sat_check.nnf";
+  c2dSize num_conflicts = 0;
+  for (uint64_t seed = 0; seed < 200; seed++) {
+    c2dSize num_vars = 3 + seed % 12;
+    TestCnf cnf = random_cnf(seed, num_vars, num_vars * (2 + seed % 3), 3);
+    double* weights = malloc(sizeof(double) * 2 * (num_vars + 1));
+    c2dSize len;
+    char* text = weighted_text(&cnf, weights, &len);
+    DimacsCnf* dimacs = dimacs_parse(text, len);
+    free(text);
+
+    for (int run = 0; run < 4; run++) {
+      BOOLEAN tracking = run & 1;
+      c2dSize budget = run & 2 ? 1 << 20 : 200;
+      char name[64];
+      sprintf(name, "tracking %s, %lu bytes", tracking ? "on" : "off", budget);
+      SatState* sat_state = sat_state_new_from_cnf(dimacs);
+      sat_set_subsumption_tracking(sat_state, tracking);
+      NnfCircuit* circuit = sat_compile(sat_state, budget);
+      num_conflicts += sat_state->num_conflicts;
+      check_circuit(seed, name, circuit, &cnf, sat_state, weights);
+
+      if (run == 0) {
+        CHECK(nnf_write(circuit, file_name), "seed %lu: the circuit cannot be written", seed);
+        NnfCircuit* read = read_circuit(file_name);
+        CHECK(read != NULL, "seed %lu: the written circuit cannot be read", seed);
+        if (read != NULL) check_circuit(seed, "written", read, &cnf, sat_state, weights);
+        if (read != NULL) nnf_circuit_free(read);
+        remove(file_name);
+      }
+      nnf_circuit_free(circuit);
+      sat_state_free(sat_state);
+    }
+    dimacs_free(dimacs);
+    free(weights);
+    free(cnf.lits);
+  }
+  CHECK(num_conflicts > 0, "no conflict was met while compiling");
+}
+
+//usage: sat_check
+int main(void) {
+  check_solve();
+  check_reduce();
+  check_assumptions();
+  check_preprocess();
+  check_probe();
+  check_portfolio();
+  check_exchange();
+  check_cubes();
+  check_components();
+  check_cache();
+  check_weights();
+  check_parse();
+  check_compile();
+
+  printf("%lu checks, %lu failed\n", num_checks, num_failed);
+  return num_failed > 0;
+}
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
+#include <math.h>
 
 /******************************************************************************
  * sat_api.h shows the function prototypes you should implement to create libsat.a
@@ -32,33 +34,265 @@
  * typedefs
  ******************************************************************************/
 
-#define BUF_LEN 32768
-
 typedef char BOOLEAN; //signed
 
 typedef unsigned long c2dSize;  //for variables, clauses, and various things
 typedef signed long c2dLiteral; //for literals
-typedef double c2dWmc;          //for (weighted) model count
+#if defined(SAT_WMC_LOG) && defined(SAT_WMC_LONG)
+#error "SAT_WMC_LOG and SAT_WMC_LONG cannot be both defined"
+#endif
+
+#ifdef SAT_WMC_LONG
+typedef long double c2dWmc;     //for (weighted) model count
+#else
+typedef double c2dWmc;          //for (weighted) model count, its logarithm with SAT_WMC_LOG
+#endif
 
 /******************************************************************************
  * Basic structures
  ******************************************************************************/
 
+typedef struct literal Lit;
+typedef struct clause Clause;
+typedef struct sat_state_t SatState;
+
 /******************************************************************************
- * Variables:
- * --You must represent variables using the following struct 
- * --Variable index must start at 1, and is no greater than the number of cnf variables
- * --Index of a variable must be of type "c2dSize"
- * --The field "mark" below and its related functions should not be changed
+ * Literal codes:
+ * --Internally a literal is encoded as 2*var for the positive literal and 2*var+1
+ * for the negative one, so that per literal data lives in flat arrays of the sat state
  ******************************************************************************/
 
-typedef struct literal Lit;
-typedef struct clause Clause;
+typedef unsigned int c2dLitCode;
+
+static inline c2dLitCode lit_code(c2dLiteral index) {
+  return index > 0 ? (c2dLitCode)(2 * index) : (c2dLitCode)(-2 * index + 1);
+}
+
+static inline c2dSize code_var(c2dLitCode code) {
+  return code >> 1;
+}
+
+static inline c2dLitCode code_op(c2dLitCode code) {
+  return code ^ 1;
+}
+
+static inline c2dLiteral code_index(c2dLitCode code) {
+  return (code & 1) ? -(c2dLiteral)(code >> 1) : (c2dLiteral)(code >> 1);
+}
 
 void clause_pointer_double_capacity(c2dSize* cap, Clause*** dyn_clauses);
 void clause_pointer_push(Clause* new_cp, Clause*** dyn_clauses, c2dSize* sz, c2dSize* cap);
 void clause_pointer_pop(Clause** dyn_clauses, c2dSize* sz);
 
+typedef struct clause_list {
+  c2dSize size;
+  c2dSize cap;
+  Clause** clauses;  // index starts from 0. It's dynamic.
+} ClauseList;
+
+typedef struct implication_list {
+  c2dSize size;
+  c2dSize cap;
+  c2dLitCode* lits;  // the other literals of the binary clauses, index starts from 0
+} ImplicationList;
+
+/******************************************************************************
+ * Clause arena:
+ * --Clauses and their literal codes are allocated next to each other in large blocks
+ * --Blocks never move, so clause pointers stay valid until the arena is compacted
+ * --Compaction only happens to learned clauses, when a conflict is analyzed, hence
+ * pointers to learned clauses should not be kept across sat_decide_literal() and
+ * sat_assert_clause()
+ ******************************************************************************/
+
+typedef struct clause_arena {
+  char** blocks;
+  c2dSize num_blocks;
+  c2dSize blocks_cap;  // capacity of the blocks list
+  c2dSize block_size;  // size of the last block in bytes
+  c2dSize used;        // bytes used in the last block
+  c2dSize live;        // bytes used by clauses in use
+  c2dSize wasted;      // bytes used by clauses which have been freed
+} ClauseArena;
+
+c2dSize clause_arena_bytes(c2dSize clause_size);
+void clause_arena_init(ClauseArena* arena, c2dSize block_size);
+Clause* clause_arena_alloc(ClauseArena* arena, c2dSize clause_size);
+void clause_arena_free(ClauseArena* arena, Clause* clause);
+void clause_arena_release(ClauseArena* arena);
+
+/******************************************************************************
+ * Variable heap:
+ * --Variables ordered by activity, the most active one on top
+ * --positions is indexed by variable, 0 if the variable is not in the heap
+ ******************************************************************************/
+
+typedef struct var_heap {
+  c2dSize size;
+  c2dSize* vars;       // starts from 1
+  c2dSize* positions;  // starts from 1
+} VarHeap;
+
+void var_heap_init(VarHeap* heap, c2dSize num_vars);
+void var_heap_insert(VarHeap* heap, c2dSize var, const double* activity);
+void var_heap_increased(VarHeap* heap, c2dSize var, const double* activity);
+c2dSize var_heap_pop(VarHeap* heap, const double* activity);
+void var_heap_release(VarHeap* heap);
+
+/******************************************************************************
+ * Weighted model counts:
+ * --c2dWmc is a double by default; built with SAT_WMC_LONG defined (make WMC=long)
+ * it is a long double, whose range (up to about 1e4932) holds the counts of large
+ * cnfs, and built with SAT_WMC_LOG defined (make WMC=log) it holds the natural
+ * logarithm of the count, which never overflows
+ * --Counts, literal weights included, should only be combined with the functions
+ * below, which work in every mode (programs using them must be linked with -lm)
+ ******************************************************************************/
+
+static inline c2dWmc wmc_zero(void) {
+#ifdef SAT_WMC_LOG
+  return -INFINITY;
+#else
+  return 0;
+#endif
+}
+
+static inline c2dWmc wmc_one(void) {
+#ifdef SAT_WMC_LOG
+  return 0;
+#else
+  return 1;
+#endif
+}
+
+//returns the count of a weight given as a number
+static inline c2dWmc wmc_from_weight(double weight) {
+#ifdef SAT_WMC_LOG
+  return log(weight);
+#else
+  return weight;
+#endif
+}
+
+static inline c2dWmc wmc_mul(c2dWmc a, c2dWmc b) {
+#ifdef SAT_WMC_LOG
+  return a + b;
+#else
+  return a * b;
+#endif
+}
+
+static inline c2dWmc wmc_add(c2dWmc a, c2dWmc b) {
+#ifdef SAT_WMC_LOG
+  if (a < b) {
+    c2dWmc t = a;
+    a = b;
+    b = t;
+  }
+  if (b == -INFINITY) return a;
+  return a + log1p(exp(b - a));
+#else
+  return a + b;
+#endif
+}
+
+//returns the natural logarithm of a count (-INFINITY for 0)
+static inline double wmc_log(c2dWmc count) {
+#if defined(SAT_WMC_LOG)
+  return count;
+#elif defined(SAT_WMC_LONG)
+  return (double)logl(count);
+#else
+  return log(count);
+#endif
+}
+
+//returns a count as a number, which is HUGE_VAL if it does not fit in a double
+static inline double wmc_value(c2dWmc count) {
+#ifdef SAT_WMC_LOG
+  return exp(count);
+#else
+  return (double)count;
+#endif
+}
+
+/******************************************************************************
+ * DIMACS cnf:
+ * --The clauses of a parsed cnf are kept in one flat array of literal codes, each
+ * clause being terminated by 0
+ * --occurrences[i] is the number of times variable i appears in the clauses
+ * --Literal weights are read from "c p weight <literal> <weight> 0" lines, and from
+ * "w <literal> <weight>" lines, where a positive literal also gives its negation the
+ * weight 1 - weight (both get 1 if weight is -1); weights[code] is the weight of the
+ * literal with that code, 1 for literals without one
+ * --Weight lines before the "p cnf" header are kept until the header is read, and the
+ * cnf is rejected if one of their literals is not a literal of the cnf
+ * --Weight lines may come after the clauses; from a pipe or a compressed file, they are
+ * only read there if a weight line or a "c t wmc" line came before the last clause
+ ******************************************************************************/
+
+typedef struct dimacs_cnf {
+  c2dSize num_vars;
+  c2dSize num_clauses;
+
+  c2dSize num_codes;
+  c2dSize codes_cap;
+  c2dLitCode* codes;
+
+  c2dSize* occurrences;  // starts from 1
+
+  double* weights;       // by literal code, NULL if the cnf has no weights
+
+  double parse_time;  // seconds
+} DimacsCnf;
+
+DimacsCnf* dimacs_parse(const char* buf, c2dSize len);
+DimacsCnf* dimacs_read_file(const char* file_name);
+DimacsCnf* dimacs_read_fd(int fd);
+DimacsCnf* dimacs_read_stream(FILE* file);
+void dimacs_free(DimacsCnf* cnf);
+
+//returns a monotonic time in seconds
+double sat_clock(void);
+
+/******************************************************************************
+ * Clause exchange:
+ * --Each search owns a ring of the short clauses it learned, which it is the only
+ * one to write, and which the other searches read from their own positions
+ * --A slot holds its sequence number: 2*position+1 while it is being written, and
+ * 2*position+2 once written, so a reader can tell whether it has been overwritten
+ * (a reader lagging more than the ring size loses the oldest clauses)
+ ******************************************************************************/
+
+#define EXCHANGE_MAX_SIZE 8      // longest clause a slot can hold
+#define EXCHANGE_RING_SIZE 1024  // slots of a ring
+
+typedef struct exchange_slot {
+  unsigned long seq;
+  unsigned int size;
+  c2dLitCode lits[EXCHANGE_MAX_SIZE];
+} ExchangeSlot;
+
+typedef struct exchange_ring {
+  unsigned long head;  // number of clauses written so far
+  ExchangeSlot* slots;
+} ExchangeRing;
+
+typedef struct clause_exchange {
+  c2dSize num_rings;
+  ExchangeRing* rings;  // one per search
+  unsigned int max_lbd; // filter of the exported clauses
+  unsigned int max_size;
+} ClauseExchange;
+
+/******************************************************************************
+ * Variables:
+ * --You must represent variables using the following struct 
+ * --Variable index must start at 1, and is no greater than the number of cnf variables
+ * --Index of a variable must be of type "c2dSize"
+ * --The field "mark" below and its related functions should not be changed
+ ******************************************************************************/
+
 typedef struct var {
   c2dSize index;  // index, starts from 1
 
@@ -80,20 +314,17 @@ typedef struct var {
  * --Positive literals' indices range from 1 to n (n is the number of cnf variables)
  * --Negative literals' indices range from -n to -1 (n is the number of cnf variables)
  * --Index of a literal must be of type "c2dLiteral"
+ * --A literal is a view: its assignment lives in the arrays of its sat state
  ******************************************************************************/
 
 struct literal {
   c2dLiteral index;   // pos from 1 to n; neg from -n to -1
-
-  c2dLiteral decision_level;  
-  Clause* decision_clause;    
+  c2dLitCode code;    // index into the literal arrays of the sat state
 
   Lit* op_lit;  
   Var* var;
 
-  c2dSize num_clauses; // number of clauses mentioning the literal
-  c2dSize dyn_cap;
-  Clause** clauses; // clauses mentioning the literal, index starts from 0. It's dynamic.
+  const SatState* sat_state;
 };
 
 /******************************************************************************
@@ -104,6 +335,8 @@ struct literal {
  * --A clause must have an array consisting of its literals
  * --The index of literal array must start at 0, and is less than the clause size
  * --The field "mark" below and its related functions should not be changed
+ * --The literal codes are stored right after the struct, lits[0] and lits[1] are
+ * watched. The literals array is only built when the clause is handed out by the API
  ******************************************************************************/
 
 #define UNIT_RESOLUTION_AFTER_DECIDING_LITERAL 2
@@ -113,54 +346,183 @@ struct literal {
 struct clause {
   c2dSize index;  
 
-  Lit** literals; // index starts from 0
-  c2dSize size;   // size of literals
-  
-  c2dSize decision_level; // the maximum decision level over all its literals
-  c2dSize num_false;      // the number of literals cannot be satisfied
+  Lit** literals; // index starts from 0, NULL until the clause is handed out
+
+  unsigned int size;             // size of lits
+  unsigned int assertion_level; 
+
+  unsigned int lbd;  // number of distinct decision levels among the literals when learned
+  float activity;    // bumped whenever the learned clause takes part in a conflict
 
-  c2dLiteral assertion_level; 
+  BOOLEAN relocated; // set when the arena is compacted, literals then points to the new copy
+  BOOLEAN deleted;   // set when the learned clause is removed by sat_reduce_learned_clauses()
 
   BOOLEAN mark; //THIS FIELD MUST STAY AS IS
+
+  c2dLitCode lits[]; // index starts from 0
 };
 
+/******************************************************************************
+ * Reasons:
+ * --A literal implied by a clause of size 3 or more has the clause as its reason
+ * --A literal implied by a binary clause through the implication lists has the other
+ * (false) literal of the clause as its reason, stored in the reason pointer itself and
+ * tagged by its lowest bit, so binary implications never load a clause
+ ******************************************************************************/
+
+static inline Clause* binary_reason(c2dLitCode lit) {
+  return (Clause*)(((uintptr_t)lit << 1) | 1);
+}
+
+static inline BOOLEAN is_binary_reason(const Clause* reason) {
+  return ((uintptr_t)reason & 1) != 0;
+}
+
+// returns the literals of the reason of the implied literal lit, lit being the first one;
+// the literals of a binary reason are written to buf
+static inline const c2dLitCode* reason_lits(const Clause* reason, c2dLitCode lit, c2dLitCode* buf, c2dSize* size) {
+  if (is_binary_reason(reason)) {
+    buf[0] = lit;
+    buf[1] = (c2dLitCode)((uintptr_t)reason >> 1);
+    *size = 2;
+    return buf;
+  }
+  *size = reason->size;
+  return reason->lits;
+}
+
 /******************************************************************************
  * SatState: 
  * --The following structure will keep track of the data needed to
  * condition/uncondition variables, perform unit resolution, and so on ...
+ * --The assignment is kept in flat arrays: values are indexed by literal code,
+ * levels and reasons by variable index
  ******************************************************************************/
 
-typedef struct sat_state_t {
+struct sat_state_t {
   c2dSize num_vars;
 
   Var** variables;  // variables variabels, start from 1
   Lit** p_literals; // positive literals, start from 1
   Lit** n_literals; // negtive literals, start from 1
 
+  BOOLEAN* values;    // 1 if the literal is true, -1 if false, 0 if free, by literal code
+  c2dWmc* weights;    // weight of each literal, by literal code (see sat_literal_weight())
+  c2dSize* levels;    // decision level of each variable, 0 if free
+  Clause** reasons;   // clause which implied each variable, NULL for decisions (see binary_reason())
+  ClauseList* watches;  // clauses of size 3 or more watching each literal, by literal code
+  ImplicationList* implications;  // by literal code, the literals implied when it becomes false
+  Clause* binary_conflict;        // holds the literals of a conflicting binary clause
+
   c2dSize num_cnf_clauses;
+  c2dSize cnf_cap;          // capacity of cnf_clauses, grows when clauses are added
   Clause** cnf_clauses;     // starts from 1
 
   c2dSize num_learned_clauses;
   c2dSize dyn_cap;
   Clause** learned_clauses; // starts from 0. it's dynamic
 
+  ClauseArena cnf_arena;      // memory of cnf_clauses
+  ClauseArena learned_arena;  // memory of learned_clauses and the asserted clause
+
   c2dSize cur_level;
 
-  Lit** decided_literals;   
+  c2dLitCode* decided_literals;   
   c2dSize num_decided_literals;
-  Lit** implied_literals;   
-  c2dSize num_implied_literals;
+
+  c2dLitCode* trail;    // instantiated literals (decided and implied) in assignment order
+  c2dSize trail_size;
+  c2dSize trail_head;   // propagation queue: trail[trail_head..trail_size) not propagated yet
+  c2dSize binary_head;  // same for the implication lists, which run ahead of the watches
   
   Clause* asserted_clause;
 
   c2dSize unit_resolution_s;  // Type of unit_resolution
 
+  c2dSize num_decisions;
+
+  // Decision heuristic
+  double* activity;   // by variable, bumped when the variable takes part in a conflict
+  double var_inc;     // activity bump of variables, grows after each conflict
+  VarHeap order;      // free variables by activity (instantiated ones are skipped lazily)
+  BOOLEAN* phases;    // by variable, the last value of the variable (1 or -1), 0 if never set
+
+  // Restarts
+  c2dSize restart_policy;
+  c2dSize num_restarts;
+  c2dSize restart_conflicts;  // conflicts since the last restart
+  c2dSize restart_limit;      // luby: conflicts allowed before the next restart
+  double lbd_fast;            // glucose: moving averages of the lbd of learned clauses,
+  double lbd_slow;            // over the recent conflicts and over the whole search
+
+  // Search
+  c2dSize conflict_limit;     // budget of each sat_solve() call, 0 if unlimited
+  c2dSize decision_limit;
+  double time_limit;          // seconds
+  BOOLEAN inconsistent;       // the empty clause has been learned
+  const volatile BOOLEAN* interrupt;  // the search stops when it is set, NULL if unused
+
+  // Answers of the last sat_solve() or sat_solve_with_assumptions() call
+  BOOLEAN* model;             // by variable, 1 if true and -1 if false (see sat_model())
+  c2dLiteral* failed_assumptions;  // see sat_failed_assumptions()
+  c2dSize num_failed_assumptions;
+
+  // Clause exchange
+  ClauseExchange* exchange;   // NULL if the learned clauses are not shared
+  c2dSize exchange_id;        // the ring written by this sat state
+  unsigned long* import_positions;  // by ring, the next clause to read
+  c2dSize num_exported;
+  c2dSize num_imported;
+
+  // Preprocessing
+  BOOLEAN* eliminated;        // by variable, 1 if the variable has been removed from the cnf
+  c2dSize num_eliminated_vars;
+  c2dLitCode* elim_stack;     // clauses removed with the eliminated variables, see extend_model()
+  c2dSize elim_size;
+
+  // Probing
+  c2dSize probe_interval;     // conflicts between two rounds run by sat_solve(), 0 disables them
+  c2dSize probe_budget;       // literals propagated by a round
+  c2dSize next_probe;         // the next round happens when num_conflicts reaches it
+  c2dSize probe_next_var;     // where the next round starts
+  c2dSize num_failed_literals;
+
+  // Subsumption tracking, NULL when it is off (see sat_set_subsumption_tracking())
+  ClauseList* occurrences;     // by literal code, the cnf clauses containing the literal
+  c2dSize* true_counts;        // by cnf clause index, the number of true literals
+  c2dSize* unsubsumed_counts;  // by variable, its occurrences in cnf clauses without a true literal
+
+  // Learned clause database reduction
+  c2dSize num_conflicts;
+  c2dSize reduce_first;     // conflicts before the first reduction, 0 disables reductions
+  c2dSize reduce_inc;       // each interval between reductions is longer by reduce_inc
+  c2dSize next_reduce;      // the next reduction happens when num_conflicts reaches it
+  c2dSize num_reductions;
+  c2dSize num_deleted_clauses;
+  float clause_inc;         // activity bump of learned clauses, grows after each conflict
+  c2dSize* level_stamps;    // by decision level, used to compute the lbd
+  c2dSize num_level_stamps; // levels below it have a stamp (see reserve_levels())
+  c2dSize stamp;
+
+  double parse_time;  // seconds spent reading the cnf and building the state
+
+  // Statistics, the counters are only maintained when the library is built with SAT_STATS
+  c2dSize num_propagations;   // literals taken from the propagation queue
+  c2dSize num_learned;        // clauses derived from conflicts
+  c2dSize learned_size_sum;
+  c2dSize learned_lbd_sum;
+  c2dSize max_trail_size;
+  double preprocess_time;     // seconds
+  double probe_time;
+  double search_time;
+
   // Auxiliary 
-  Lit** tmp_lit_list;
-  BOOLEAN* seen;
-  Lit** lit_list;
+  c2dLitCode* tmp_lit_list;
+  BOOLEAN* seen;          // by variable, all 0 outside of conflict analysis
+  c2dLitCode* lit_list;
+  c2dLitCode* clear_list;
 
-} SatState;
+};
 
 /******************************************************************************
  * API: 
@@ -193,6 +555,7 @@ Var* sat_literal_var(const Lit* lit);
 BOOLEAN sat_instantiated_var(const Var* var);
 
 //returns 1 if all the clauses mentioning the variable are subsumed, 0 otherwise
+//(in constant time when subsumption tracking is on)
 BOOLEAN sat_irrelevant_var(const Var* var);
 
 //returns the number of variables in the cnf of sat state
@@ -223,10 +586,23 @@ Lit* sat_pos_literal(const Var* var);
 //returns the negative literal of a variable
 Lit* sat_neg_literal(const Var* var);
 
+//returns the weight of a literal given by the cnf (1 if it has none), as a count: its logarithm
+//when the library is built with SAT_WMC_LOG
+c2dWmc sat_literal_weight(const Lit* lit);
+
 //returns 1 if the literal is implied, 0 otherwise
 //a literal is implied by deciding its variable, or by inference using unit resolution
 BOOLEAN sat_implied_literal(const Lit* lit);
 
+//returns the literal to decide next: the free variable with the highest activity, set
+//to the value it had last (negative if it has never been set)
+//returns NULL if all variables are instantiated
+Lit* sat_next_decision(SatState* sat_state);
+
+//diversifies the search of sat state from the given seed: the variables get random initial
+//phases, and a small random activity which breaks the ties of the decision heuristic
+void sat_set_seed(SatState* sat_state, unsigned long seed);
+
 //sets the literal to true, and then runs unit resolution
 //returns a learned clause if unit resolution detected a contradiction, NULL otherwise
 Clause* sat_decide_literal(Lit* lit, SatState* sat_state);
@@ -234,8 +610,18 @@ Clause* sat_decide_literal(Lit* lit, SatState* sat_state);
 //undoes the last literal decision and the corresponding implications obtained by unit resolution
 void sat_undo_decide_literal(SatState* sat_state);
 
+//undoes all decisions above level (and their implications) at once, so that the decision
+//level of the sat state becomes level; nothing happens if it is at level or below already
+void sat_backtrack_to_level(c2dSize level, SatState* sat_state);
+
 /******************************************************************************
  * Clauses 
+ * --Clauses are handed out by sat_index2clause(), sat_clause_of_var(), sat_add_clause(),
+ * and as the learned clause of sat_decide_literal() or sat_assert_clause()
+ * --Cnf clauses stay valid until sat_preprocess() replaces them; a learned clause may be
+ * deleted by sat_reduce_learned_clauses() or moved when its arena is compacted (see
+ * "Clause arena"), so its pointer should not be kept across sat_decide_literal(),
+ * sat_assert_clause(), sat_reduce_learned_clauses() or sat_solve()
  ******************************************************************************/
 
 //returns a clause structure for the corresponding index
@@ -244,13 +630,16 @@ Clause* sat_index2clause(c2dSize index, const SatState* sat_state);
 //returns the index of a clause
 c2dSize sat_clause_index(const Clause* clause);
 
-//returns the literals of a clause
+//returns the literals of a clause, or NULL for a clause which has not been handed out (e.g.
+//one reached through the fields of the sat state)
 Lit** sat_clause_literals(const Clause* clause);
 
 //returns the number of literals in a clause
 c2dSize sat_clause_size(const Clause* clause);
 
-//returns 1 if the clause is subsumed, 0 otherwise
+//returns 1 if the clause is subsumed, 0 otherwise (also for a clause without literals, or
+//one which has not been handed out)
+//(in constant time for cnf clauses when subsumption tracking is on)
 BOOLEAN sat_subsumed_clause(const Clause* clause);
 
 //returns the number of clauses in the cnf of sat state
@@ -274,8 +663,23 @@ void sat_state_debug(SatState* sat_state);
 void sat_clause_debug(Clause* clause);
 
 //constructs a SatState from an input cnf file
+//returns NULL if the file cannot be read or is not a valid cnf
 SatState* sat_state_new(const char* file_name);
 
+//constructs a SatState from a cnf read from an open file descriptor or stream, e.g. a pipe
+//the input is read up to its last clause and is not closed
+//
+//gzip, xz and bzip2 compressed input (sat_state_new included) is recognized by its magic
+//bytes or file extension, and decompressed while it is parsed
+SatState* sat_state_new_from_fd(int fd);
+SatState* sat_state_new_from_stream(FILE* file);
+
+//constructs a SatState from a parsed cnf, which is not modified
+SatState* sat_state_new_from_cnf(const DimacsCnf* cnf);
+
+//returns the number of seconds spent reading the cnf and building the sat state
+double sat_parse_time(const SatState* sat_state);
+
 //frees the SatState
 void sat_state_free(SatState* sat_state);
 
@@ -287,6 +691,17 @@ BOOLEAN sat_unit_resolution(SatState* sat_state);
 //after sat_unit_resolution()
 void sat_undo_unit_resolution(SatState* sat_state);
 
+//sets when learned clauses are deleted: the first reduction happens after first conflicts,
+//and every later one inc conflicts later than the previous interval (first = 0 disables it)
+void sat_set_reduce_schedule(SatState* sat_state, c2dSize first, c2dSize inc);
+
+//deletes about half of the learned clauses, keeping those with an lbd of at most 2 and those
+//which are the reasons of instantiated literals; clauses with a higher lbd and a lower
+//activity go first. Learned clause indices are renumbered and pointers to learned clauses
+//become invalid, including the one returned by the last sat_decide_literal() or
+//sat_assert_clause() (sat_state->asserted_clause is kept up to date)
+void sat_reduce_learned_clauses(SatState* sat_state);
+
 //returns 1 if the decision level of the sat state equals to the assertion level of clause,
 //0 otherwise
 //
@@ -295,11 +710,585 @@ void sat_undo_unit_resolution(SatState* sat_state);
 BOOLEAN sat_at_assertion_level(const Clause* clause, const SatState* sat_state);
 
 /******************************************************************************
- * The functions below are already implemented for you and MUST STAY AS IS
+ * Subsumption tracking:
+ * --Off by default: sat_irrelevant_var() and sat_subsumed_clause() then check the
+ * literals of the clauses
+ * --When it is on, every cnf clause keeps its number of true literals and every
+ * variable the number of its cnf clauses which are not subsumed, so both queries are
+ * a single load; setting and unsetting a literal then visits the cnf clauses containing
+ * it, which slows down unit resolution
  ******************************************************************************/
 
-//returns the weight of a literal (which is simply 1 for our purposes)
-c2dWmc sat_literal_weight(const Lit* lit);
+//turns on (1) or off (0) the counts which make sat_irrelevant_var() and sat_subsumed_clause()
+//take constant time; they are updated whenever a literal is set or unset, so they are off by
+//default
+void sat_set_subsumption_tracking(SatState* sat_state, BOOLEAN on);
+
+//counts the cnf clauses again after they have been replaced, if the counts are kept
+void subsumption_clauses_replaced(SatState* sat_state);
+
+//counts a cnf clause added to the sat state, if the counts are kept
+void subsumption_clause_added(Clause* clause, SatState* sat_state);
+
+//updates the counts once lit has become true (called only when they are kept)
+void subsumption_assigned(c2dLitCode lit, SatState* sat_state);
+
+//updates the counts once lit is not true anymore (called only when they are kept)
+void subsumption_unassigned(c2dLitCode lit, SatState* sat_state);
+
+/******************************************************************************
+ * Components:
+ * --The residual cnf (the cnf clauses which are not subsumed, restricted to the free
+ * variables) falls apart into components, which share no variable
+ * --A component stack holds frames of components: sat_components() pushes the
+ * components of the whole residual cnf, and after more literals are set,
+ * sat_split_component() pushes the components a component of an earlier frame falls
+ * into, visiting only that component; the frame is popped when the literals are undone
+ * --The variables and clauses of the components are kept in the arrays of the stack,
+ * which are reused from one frame to the next
+ * --The mark fields of the variables and the cnf clauses are used while splitting, and
+ * are all 0 again afterwards
+ ******************************************************************************/
+
+typedef struct component {
+  c2dSize vars_start;     // the variable indices are vars[vars_start..vars_start + num_vars)
+  c2dSize num_vars;
+  c2dSize clauses_start;  // the cnf clause indices are clauses[clauses_start..clauses_start + num_clauses)
+  c2dSize num_clauses;
+} Component;
+
+typedef struct component_stack {
+  Component* components;
+  c2dSize num_components;
+  c2dSize components_cap;
+  c2dSize* frames;        // by frame, its first component
+  c2dSize num_frames;
+  c2dSize frames_cap;
+  c2dSize* vars;
+  c2dSize num_vars;
+  c2dSize vars_cap;
+  c2dSize* clauses;
+  c2dSize num_clauses;
+  c2dSize clauses_cap;
+} ComponentStack;
+
+//returns an empty component stack for the cnf of sat state
+ComponentStack* component_stack_new(const SatState* sat_state);
+
+//frees a component stack
+void component_stack_free(ComponentStack* stack);
+
+//pushes a frame with the components of the cnf of sat state under its current assignment:
+//its free variables (eliminated ones aside), connected by the cnf clauses which are not
+//subsumed; a variable in no such clause is a component of its own
+//returns the number of components of the frame
+c2dSize sat_components(SatState* sat_state, ComponentStack* stack);
+
+//pushes a frame with the components the given component (of an earlier frame) falls into under
+//the current assignment of sat state, which must extend the one the component was found under
+//returns the number of components of the frame
+c2dSize sat_split_component(c2dSize component, SatState* sat_state, ComponentStack* stack);
+
+//pops the last frame of the stack
+void component_stack_pop(ComponentStack* stack);
+
+//returns the number of components of the last frame, and sets *first to the first one
+c2dSize component_stack_top(const ComponentStack* stack, c2dSize* first);
+
+//returns the variable indices of a component, and sets *size to their number
+const c2dSize* component_vars(const ComponentStack* stack, c2dSize component, c2dSize* size);
+
+//returns the cnf clause indices of a component, and sets *size to their number
+const c2dSize* component_clauses(const ComponentStack* stack, c2dSize component, c2dSize* size);
+
+/******************************************************************************
+ * Component cache:
+ * --Keeps the counts of components, or the circuit nodes compiling them, keyed by
+ * their variable indices and cnf clause indices (as given by sat_index2clause()),
+ * which together fix the residual cnf of the component; the indices are sorted and
+ * packed into a few bytes each
+ * --The entries and their keys take at most budget bytes, the least recently used
+ * entries are evicted first
+ * --Each store is journaled, so that the entries stored since a mark can be forgotten,
+ * e.g. those computed under an assignment which turned out to be conflicting
+ ******************************************************************************/
+
+typedef enum {
+  CACHE_COUNTS,  // (weighted) model counts, see component_cache_lookup()
+  CACHE_NODES    // nodes of a circuit, see component_cache_lookup_node()
+} CacheContent;
+
+typedef struct cache_entry {
+  uint64_t hash;
+  union {
+    c2dWmc count;
+    c2dSize node;
+  } value;              // which one is given by the content of the cache
+  unsigned char* key;
+  c2dSize key_len;
+  c2dSize stamp;        // position of the store of the entry in the journal
+  c2dSize bucket_next;  // next entry of the hash bucket, or of the free list
+  c2dSize lru_prev;     // entry used more recently
+  c2dSize lru_next;     // entry used less recently
+} CacheEntry;
+
+typedef struct component_cache {
+  CacheContent content;
+  c2dSize budget;       // bytes
+  c2dSize bytes;        // taken by the entries and their keys
+  c2dSize num_entries;
+  CacheEntry* entries;
+  c2dSize entries_cap;
+  c2dSize num_used;     // entries ever used, the free ones are linked from free_entries
+  c2dSize free_entries;
+  c2dSize* buckets;     // first entry of each bucket
+  c2dSize num_buckets;  // a power of 2
+  c2dSize lru_first;    // most recently used entry
+  c2dSize lru_last;     // least recently used entry, the next one evicted
+  unsigned char* key;   // key of the last lookup or store
+  c2dSize key_cap;
+  c2dSize* sort_buf;
+  c2dSize sort_cap;
+  c2dSize* journal;     // by store, the entry it made or updated
+  c2dSize journal_size;
+  c2dSize journal_cap;
+
+  c2dSize num_hits;
+  c2dSize num_misses;
+  c2dSize num_stores;
+  c2dSize num_evictions;
+  c2dSize num_forgotten;
+} ComponentCache;
+
+//returns an empty component cache taking up to budget bytes (entries and keys), which holds
+//counts (CACHE_COUNTS) or circuit nodes (CACHE_NODES)
+ComponentCache* component_cache_new(c2dSize budget, CacheContent content);
+
+//frees a component cache
+void component_cache_free(ComponentCache* cache);
+
+//looks up the count of the component given by its variable and cnf clause indices (in any
+//order), as found by sat_components() or sat_split_component()
+//returns 1 and sets *count on a hit, 0 on a miss
+BOOLEAN component_cache_lookup(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                               const c2dSize* clauses, c2dSize num_clauses, c2dWmc* count);
+
+//stores the count of the component, evicting the least recently used entries to stay within
+//the budget; a component whose entry alone exceeds the budget is not stored
+void component_cache_store(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                           const c2dSize* clauses, c2dSize num_clauses, c2dWmc count);
+
+//looks up the node of the component, as component_cache_lookup() does its count
+//returns 1 and sets *node on a hit, 0 on a miss
+BOOLEAN component_cache_lookup_node(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                                    const c2dSize* clauses, c2dSize num_clauses, c2dSize* node);
+
+//stores the node of the component, as component_cache_store() does its count
+void component_cache_store_node(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                                const c2dSize* clauses, c2dSize num_clauses, c2dSize node);
+
+//returns a mark of the stores made so far, for component_cache_forget()
+c2dSize component_cache_mark(const ComponentCache* cache);
+
+//removes the entries stored or updated since mark was returned by component_cache_mark()
+void component_cache_forget(ComponentCache* cache, c2dSize mark);
+
+//prints the hits, misses, stores, evictions and size of the cache
+void component_cache_print_stats(const ComponentCache* cache, FILE* file);
+
+/******************************************************************************
+ * Decision-DNNF compilation:
+ * --sat_compile() compiles the cnf of sat state top-down: a variable of a component
+ * is decided both ways, and each way is the conjunction of the literals set by unit
+ * resolution and of the compilations of the components the rest falls into (see
+ * sat_split_component())
+ * --A conflict is analyzed as in sat_solve(): the compilation backtracks to the
+ * assertion level of the learned clause, asserts it there, and splits the component
+ * of that level again
+ * --Nodes are numbered in the order they are made, children before parents, and
+ * the children of all nodes are kept in one flat array; a unique table hash-conses
+ * the nodes, so a node equal to an existing one is never made twice
+ * --Node 0 is false (an or node without children) and node 1 is true (an and node
+ * without children)
+ ******************************************************************************/
+
+#define NNF_FALSE 0
+#define NNF_TRUE 1
+
+typedef enum {
+  NNF_LITERAL,
+  NNF_AND,
+  NNF_OR
+} NnfKind;
+
+typedef struct nnf_node {
+  NnfKind kind;
+  c2dLiteral literal;   // literal of a leaf, decision variable of an or node (0 for false)
+  c2dSize num_children;
+  c2dSize children;     // the children are NnfCircuit::children[children..children + num_children)
+  uint64_t hash;
+  c2dSize bucket_next;  // next node of the unique table bucket
+} NnfNode;
+
+typedef struct nnf_circuit {
+  c2dSize num_vars;
+  c2dSize root;         // the compiled cnf, set by sat_compile()
+  NnfNode* nodes;
+  c2dSize num_nodes;
+  c2dSize nodes_cap;
+  c2dSize* children;
+  c2dSize num_children;
+  c2dSize children_cap;
+  c2dSize* buckets;     // first node of each bucket of the unique table
+  c2dSize num_buckets;  // a power of 2
+  c2dSize num_shared;   // nodes found in the unique table instead of being made
+  double compile_time;  // seconds
+} NnfCircuit;
+
+//returns a circuit over num_vars variables with the nodes false and true only
+NnfCircuit* nnf_circuit_new(c2dSize num_vars);
+
+//frees a circuit
+void nnf_circuit_free(NnfCircuit* circuit);
+
+//returns the node of a literal
+c2dSize nnf_literal(NnfCircuit* circuit, c2dLiteral literal);
+
+//returns the node of the conjunction of children (which are reordered), dropping true children;
+//it is false if one of them is false, and the child itself if there is one left
+c2dSize nnf_and(NnfCircuit* circuit, c2dSize* children, c2dSize num_children);
+
+//returns the decision node on var: high (which must imply var) or low (which must imply its
+//negation); it is the other one if one of them is false
+c2dSize nnf_decision(NnfCircuit* circuit, c2dSize var, c2dSize high, c2dSize low);
+
+//compiles the cnf of sat state into a Decision-DNNF, caching the compilation of components in
+//up to cache_budget bytes; the root is false if the cnf is unsatisfiable
+//the sat state keeps the clauses learned, and is left at the first decision level; it must not
+//have been simplified by sat_preprocess(), which does not keep the models of the cnf
+NnfCircuit* sat_compile(SatState* sat_state, c2dSize cache_budget);
+
+//writes the nodes reachable from the root in the NNF format of c2d, children first
+//returns 0 if the file cannot be written, 1 otherwise
+BOOLEAN nnf_write(const NnfCircuit* circuit, const char* file_name);
+
+//prints the size of the circuit and the time it took to compile
+void nnf_print_stats(const NnfCircuit* circuit, FILE* file);
+
+/******************************************************************************
+ * Statistics:
+ * --sat_stats() gathers the counters of a sat state, it is cheap enough to be called
+ * while solving (e.g. from another thread, for progress reports)
+ * --The counters updated in the search loop (propagations, learned clause sizes and
+ * lbds, and trail depth) are only maintained when the library is built with SAT_STATS
+ * defined (make STATS=1, the default); they are 0 otherwise, and the search loop does
+ * not pay for them
+ ******************************************************************************/
+
+#ifdef SAT_STATS
+#define SAT_STAT(statement) do { statement; } while (0)
+#else
+#define SAT_STAT(statement) do { } while (0)
+#endif
+
+typedef struct sat_stats {
+  c2dSize decisions;
+  c2dSize propagations;
+  c2dSize conflicts;
+  c2dSize learned_clauses;      // derived from conflicts
+  c2dSize kept_learned_clauses; // currently in the learned clause database
+  c2dSize deleted_clauses;
+  c2dSize reductions;
+  c2dSize restarts;
+  double avg_learned_size;
+  double avg_learned_lbd;
+  c2dSize trail_depth;          // instantiated literals
+  c2dSize max_trail_depth;
+  double parse_time;            // seconds
+  double preprocess_time;
+  double probe_time;
+  double search_time;           // in sat_solve(), probing included
+} SatStats;
+
+//returns the statistics of sat state
+SatStats sat_stats(const SatState* sat_state);
+
+/******************************************************************************
+ * Tracing:
+ * --A tracer records the main phases (parsing, unit resolution, conflict analysis and
+ * undoing) of the thread which started it: calls, time, and the hardware counters
+ * of perf_event_open() (cycles, instructions, branch misses, L1d and LLC read misses)
+ * --The phases are only marked when the library is built with SAT_TRACE defined
+ * (make TRACE=1); otherwise they cost nothing, and a tracer records nothing
+ * --sat_tracer_print_summary() prints the totals per phase, and
+ * sat_tracer_write_timeline() the events as a Chrome trace (JSON)
+ ******************************************************************************/
+
+typedef enum {
+  TRACE_PARSE,
+  TRACE_UNIT_RESOLUTION,
+  TRACE_ANALYSIS,
+  TRACE_UNDO,
+  TRACE_NUM_PHASES
+} TracePhase;
+
+typedef enum {
+  TRACE_CYCLES,
+  TRACE_INSTRUCTIONS,
+  TRACE_BRANCH_MISSES,
+  TRACE_L1D_MISSES,
+  TRACE_LLC_MISSES,
+  TRACE_NUM_COUNTERS
+} TraceCounter;
+
+typedef struct sat_tracer SatTracer;
+
+#ifdef SAT_TRACE
+#define SAT_TRACE_BEGIN(phase) sat_trace_begin(phase)
+#define SAT_TRACE_END(phase) sat_trace_end(phase)
+#else
+#define SAT_TRACE_BEGIN(phase) do { } while (0)
+#define SAT_TRACE_END(phase) do { } while (0)
+#endif
+
+//returns a tracer keeping up to max_events events for the timeline (0 for the summary only)
+SatTracer* sat_tracer_new(c2dSize max_events);
+
+//opens the counters of tracer for the calling thread, whose phases it records from now on
+void sat_tracer_start(SatTracer* tracer);
+
+//stops recording the phases of the calling thread, and closes the counters of tracer
+void sat_tracer_stop(SatTracer* tracer);
+
+//frees the tracer, stopping it first (from the thread which started it)
+void sat_tracer_free(SatTracer* tracer);
+
+//returns the number of hardware counters the tracer could open
+c2dSize sat_tracer_num_counters(const SatTracer* tracer);
+
+//prints the calls, time and counters of every phase
+void sat_tracer_print_summary(const SatTracer* tracer, FILE* file);
+
+//writes the recorded events in the Chrome trace format (for chrome://tracing or Perfetto)
+//returns 0 if the file cannot be written, 1 otherwise
+BOOLEAN sat_tracer_write_timeline(const SatTracer* tracer, const char* file_name);
+
+//opens a phase in the tracer of the current thread, if any (called through SAT_TRACE_BEGIN)
+void sat_trace_begin(TracePhase phase);
+
+//closes the phase opened last, which must be phase (called through SAT_TRACE_END)
+void sat_trace_end(TracePhase phase);
+
+/******************************************************************************
+ * Restarts:
+ * --RESTART_LUBY restarts after LUBY_UNIT times the next term of the Luby sequence
+ * (1, 1, 2, 1, 1, 2, 4, ...) conflicts
+ * --RESTART_GLUCOSE restarts when the lbd of the recently learned clauses gets worse
+ * than the average over the whole search
+ * --The policy is updated on each conflict, and consulted by the search loop afterwards
+ ******************************************************************************/
+
+#define RESTART_NONE 0
+#define RESTART_LUBY 1
+#define RESTART_GLUCOSE 2
+
+//sets the restart policy (RESTART_NONE, RESTART_LUBY or RESTART_GLUCOSE)
+void sat_set_restart_policy(SatState* sat_state, c2dSize policy);
+
+//returns 1 if the restart policy asks for a restart, 0 otherwise
+BOOLEAN sat_restart_due(const SatState* sat_state);
+
+//backtracks to the first decision level, and starts counting conflicts toward the next restart
+void sat_restart(SatState* sat_state);
+
+//counts a conflict toward the next restart, and updates the lbd averages with the lbd of the
+//clause learned from it (called by sat_unit_resolution() on a conflict)
+void restart_on_conflict(unsigned int lbd, SatState* sat_state);
+
+/******************************************************************************
+ * Search:
+ * --sat_solve() runs the whole CDCL search with the primitives above, without recursion
+ * --A satisfying assignment is left in place, so the literals of the model are implied
+ * --The learned clauses, activities and phases are kept, and the next call backtracks
+ * to the first decision level before searching again
+ * --Clauses added with sat_add_clause() and assumptions given to
+ * sat_solve_with_assumptions() between calls make the search incremental
+ ******************************************************************************/
+
+#define SAT_UNKNOWN 0
+#define SAT_SATISFIABLE 10
+#define SAT_UNSATISFIABLE 20
+
+//sets the budget of each sat_solve() call: the number of conflicts, the number of decisions,
+//and the number of seconds; 0 means no limit
+void sat_set_solve_limits(SatState* sat_state, c2dSize conflicts, c2dSize decisions, double seconds);
+
+//decides the satisfiability of the cnf of sat state
+//returns SAT_SATISFIABLE, SAT_UNSATISFIABLE, or SAT_UNKNOWN when the budget runs out
+int sat_solve(SatState* sat_state);
+
+//makes the sat_solve() calls of sat state return SAT_UNKNOWN as soon as *flag is set (by another
+//thread, or a signal handler), NULL to stop watching it; the flag is read with an acquire load,
+//so another thread should set it with a release store (__atomic_store_n)
+void sat_set_interrupt(SatState* sat_state, const volatile BOOLEAN* flag);
+
+//adds a clause to the cnf of sat state, given by the indices of its literals
+//the clause becomes the last cnf clause, the learned clauses are renumbered after it, and the
+//sat state backtracks to the first decision level
+//returns the new clause, or NULL if one of the literals does not belong to the cnf (or its
+//variable has been eliminated by sat_preprocess())
+Clause* sat_add_clause(const c2dLiteral* literals, c2dSize size, SatState* sat_state);
+
+//decides the satisfiability of the cnf of sat state together with the assumed literals,
+//which are decided first, one per decision level (so they are part of the model on SAT)
+//on SAT_UNSATISFIABLE, sat_failed_assumptions() gives the assumptions which caused it
+//returns SAT_UNKNOWN if one of the assumptions is not a literal of the cnf (or its variable has
+//been eliminated by sat_preprocess())
+int sat_solve_with_assumptions(const c2dLiteral* assumptions, c2dSize num_assumptions, SatState* sat_state);
+
+//returns the assumptions which made the last sat_solve_with_assumptions() call unsatisfiable,
+//and sets *size to their number; it is empty when the cnf itself is unsatisfiable
+const c2dLiteral* sat_failed_assumptions(const SatState* sat_state, c2dSize* size);
+
+//returns the model found by the last sat_solve() call which returned SAT_SATISFIABLE,
+//by variable index: 1 if the variable is true, -1 if it is false
+const BOOLEAN* sat_model(const SatState* sat_state);
+
+//makes room in the arrays indexed by decision level for the levels below num_levels
+void reserve_levels(c2dSize num_levels, SatState* sat_state);
+
+/******************************************************************************
+ * Portfolio:
+ * --sat_portfolio_solve() runs several searches of the same cnf in parallel, each one in
+ * its own thread and sat state, with different seeds, restart policies and options
+ * --The sat states are built from the parsed cnf, which they share and only read; each
+ * one has its own assignment, clauses and scratch buffers
+ * --The first answer stops the other searches (programs must be linked with -lpthread)
+ ******************************************************************************/
+
+//decides the satisfiability of cnf with num_threads parallel searches, within seconds (0 for
+//no limit); on SAT_SATISFIABLE, model (num_vars + 1 entries) receives the model by variable
+//index, 1 if true and -1 if false
+//returns SAT_SATISFIABLE, SAT_UNSATISFIABLE, or SAT_UNKNOWN when the time runs out
+int sat_portfolio_solve(const DimacsCnf* cnf, c2dSize num_threads, double seconds, BOOLEAN* model);
+
+/******************************************************************************
+ * Cube and conquer:
+ * --sat_lookahead_cubes() splits the cnf into cubes, the assignments of a few literals
+ * picked by lookahead, so that the cnf is satisfiable if and only if one of the cubes is
+ * --sat_solve_cubes() solves the cubes with a pool of threads, each one with its own sat
+ * state; idle threads steal cubes from the others, and learned units are shared
+ * --The result and the time of each cube are kept in the cube set
+ ******************************************************************************/
+
+typedef struct cube_set {
+  c2dSize num_cubes;
+  c2dSize cap;
+  c2dSize* starts;    // cube i is lits[starts[i]..starts[i + 1])
+  c2dLiteral* lits;
+  c2dSize lits_cap;
+  int* results;       // by cube, set by sat_solve_cubes()
+  double* times;      // by cube, seconds spent solving it
+} CubeSet;
+
+//splits the cnf of sat state into cubes of max_depth split literals (besides the literals
+//forced by lookahead); the cnf is unsatisfiable if and only if every cube is
+//the sat state is left at the first decision level
+CubeSet* sat_lookahead_cubes(SatState* sat_state, c2dSize max_depth);
+
+//solves the cubes of the cnf with num_threads workers, within seconds (0 for no limit); the
+//result and the time of each cube are recorded in cubes (SAT_UNKNOWN for the cubes which were
+//not solved); on SAT_SATISFIABLE, model (num_vars + 1 entries) receives the model by variable
+//returns SAT_SATISFIABLE, SAT_UNSATISFIABLE, or SAT_UNKNOWN when the time runs out
+int sat_solve_cubes(const DimacsCnf* cnf, CubeSet* cubes, c2dSize num_threads, double seconds, BOOLEAN* model);
+
+//frees a cube set
+void cube_set_free(CubeSet* cubes);
+
+/******************************************************************************
+ * Clause sharing:
+ * --A sat state attached to a clause exchange exports the clauses it learns which pass
+ * the lbd and size filter, and imports the clauses of the others after restarts, at the
+ * first decision level
+ * --Exporting never waits: a clause is written to the ring of the sat state, the
+ * readers check the sequence numbers of the slots
+ * --The sat states must be built from the same cnf; imported clauses mentioning a
+ * variable eliminated by sat_preprocess() are skipped
+ ******************************************************************************/
+
+//returns a clause exchange between num_searches sat states, which shares the learned clauses
+//with an lbd up to max_lbd and a size up to max_size (at most EXCHANGE_MAX_SIZE)
+ClauseExchange* clause_exchange_new(c2dSize num_searches, unsigned int max_lbd, unsigned int max_size);
+
+//frees the clause exchange, once no sat state uses it
+void clause_exchange_free(ClauseExchange* exchange);
+
+//attaches sat state to the clause exchange, as search id (from 0 to num_searches - 1)
+void sat_set_clause_exchange(SatState* sat_state, ClauseExchange* exchange, c2dSize id);
+
+//learns the clauses exported by the other sat states since the last call, at the first
+//decision level, where the sat state must be
+//returns 0 if the cnf is found unsatisfiable, 1 otherwise
+BOOLEAN sat_import_clauses(SatState* sat_state);
+
+//writes a clause learned by sat state to its ring, if it passes the filter of the exchange
+void export_clause(const Clause* clause, SatState* sat_state);
+
+//asserts clause at the first decision level, then the clauses learned from the conflicts it
+//leads to; returns 0 if the empty clause is learned
+BOOLEAN assert_at_first_level(Clause* clause, SatState* sat_state);
+
+//learns a clause implied by the cnf (imported, or found by sat_probe()) at the first decision
+//level, where the sat state must be; returns 0 if the cnf turns out to be unsatisfiable
+BOOLEAN learn_implied_clause(const c2dLitCode* lits, c2dSize size, SatState* sat_state);
+
+/******************************************************************************
+ * Preprocessing:
+ * --sat_preprocess() simplifies the cnf clauses of a new sat state before the search:
+ * units, equivalent literals, subsumption, self-subsuming resolution, and bounded
+ * variable elimination
+ * --The cnf clauses are replaced, so clause indices and occurrence lists change; the
+ * variables keep their indices
+ * --Eliminated variables get their values back when sat_solve() finds a model
+ ******************************************************************************/
+
+//simplifies the cnf of sat state, which must be called before the first unit resolution
+//(it does nothing otherwise); eliminated variables cannot be used by clauses added later
+//or as assumptions
+//returns 0 if the cnf is found unsatisfiable, 1 otherwise
+BOOLEAN sat_preprocess(SatState* sat_state);
+
+//replaces the cnf clauses of a sat state which has not been used yet (used by sat_preprocess())
+void replace_cnf_clauses(SatState* sat_state, const c2dLitCode* codes, c2dSize num_clauses);
+
+//sets a literal at the current decision level without a reason (used by extend_model())
+void assign_literal(c2dLitCode lit, SatState* sat_state);
+
+//gives values to the eliminated variables in the model, once the others satisfy the cnf
+void extend_model(SatState* sat_state);
+
+/******************************************************************************
+ * Probing:
+ * --sat_probe() decides free variables both ways at the first decision level; a value
+ * which leads to a conflict fixes the variable to the other value, the literals implied
+ * by both values are fixed, and some implications through longer clauses are learned as
+ * binary clauses (hyper-binary resolution)
+ * --sat_solve() runs a round after a restart every probe_interval conflicts
+ ******************************************************************************/
+
+//decides the free variables both ways at the first decision level, learning failed literals,
+//literals implied by both values, and hyper-binary resolvents; stops after propagating about
+//budget literals, and the next call goes on from there
+//returns 0 if the cnf is found unsatisfiable, 1 otherwise
+BOOLEAN sat_probe(SatState* sat_state, c2dSize budget);
+
+//sets when sat_solve() probes: every interval conflicts (0 disables it), propagating at most
+//budget literals each time
+void sat_set_probe_schedule(SatState* sat_state, c2dSize interval, c2dSize budget);
+
+/******************************************************************************
+ * The functions below are already implemented for you and MUST STAY AS IS
+ ******************************************************************************/
 
 //returns 1 if a variable is marked, 0 otherwise
 BOOLEAN sat_marked_var(const Var* var);
@@ -1,5 +1,14 @@
 #include "sat_api.h"
 
+#define LEARNED_ARENA_BLOCK ((c2dSize)1 << 20) // initial size of learned clause blocks in bytes
+
+#define REDUCE_FIRST 2000   // default schedule of learned clause reductions, in conflicts
+#define REDUCE_INC 300
+#define CLAUSE_DECAY 0.999f // clause activities decay by this factor after each conflict
+#define VAR_DECAY 0.95      // variable activities decay by this factor after each conflict
+#define PROBE_INTERVAL 5000 // default schedule of probing in sat_solve(), in conflicts
+#define PROBE_BUDGET 100000 // default literals propagated by a round of probing
+
 /******************************************************************************
  * We explain here the functions you need to implement
  *
@@ -17,10 +26,9 @@
  ******************************************************************************/
 
 void sat_clause_debug(Clause* clause) {
-  printf("Clause: %lu %lu\n", clause->index, clause->size);
+  printf("Clause: %lu %u\n", clause->index, clause->size);
   for (c2dSize i = 0; i < clause->size; i++) {
-    printf("%ld(%lu) ", clause->literals[i]->index, clause->literals[i]->op_lit->
-      decision_level);
+    printf("%ld ", code_index(clause->lits[i]));
   }
   printf("\n");
 }
@@ -28,9 +36,9 @@ void sat_clause_debug(Clause* clause) {
 void sat_state_debug(SatState* sat_state) {
   printf("%lu %lu\n", sat_state->num_vars, sat_state->num_cnf_clauses);
   for (c2dSize i = 1; i <= sat_state->num_cnf_clauses; i++) {
-    printf("Clause %lu: %lu\n", sat_state->cnf_clauses[i]->index, sat_state->cnf_clauses[i]->size);
+    printf("Clause %lu: %u\n", sat_state->cnf_clauses[i]->index, sat_state->cnf_clauses[i]->size);
     for (c2dSize j = 0; j < sat_state->cnf_clauses[i]->size; j++) {
-      printf("%ld ", sat_state->cnf_clauses[i]->literals[j]->index);
+      printf("%ld ", code_index(sat_state->cnf_clauses[i]->lits[j]));
     }
     printf("\n");
   }
@@ -44,18 +52,18 @@ void sat_state_debug(SatState* sat_state) {
     printf("\n");
   }
   printf("\n");
-  
+
   printf("num_decided_literals: %lu\n", sat_state->num_decided_literals);
   for (c2dSize i = 0; i < sat_state->num_decided_literals; i++) {
-    printf("%ld ", sat_state->decided_literals[i]->index);
+    printf("%ld ", code_index(sat_state->decided_literals[i]));
   }
   printf("\n");
 
-  printf("num_implied_literals: %lu\n", sat_state->num_implied_literals);
-  for (c2dSize i = 0; i < sat_state->num_implied_literals; i++) {
-    printf("%ld ", sat_state->implied_literals[i]->index);
+  printf("trail_size: %lu\n", sat_state->trail_size);
+  for (c2dSize i = 0; i < sat_state->trail_size; i++) {
+    printf("%ld ", code_index(sat_state->trail[i]));
   }
-  printf("\n");   
+  printf("\n");
 }
 
 /******************************************************************************
@@ -80,27 +88,47 @@ void clause_pointer_pop(Clause** dyn_clauses, c2dSize* sz) {
   *sz -= 1;
 }
 
+static void implication_push(c2dLitCode lit, ImplicationList* list) {
+  if (list->size + 1 >= list->cap) {
+    list->cap *= 2;
+    list->lits = realloc(list->lits, list->cap * sizeof(c2dLitCode));
+  }
+  list->lits[list->size++] = lit;
+}
+
 // updates the list of the clause mentioning variables
-void push_clause_to_vars(Clause* clause) {
+void push_clause_to_vars(Clause* clause, SatState* sat_state) {
   Var* var;
-  Lit* lit;
   for (c2dSize i = 0; i < clause->size; i++) {
-    lit = clause->literals[i];
-    clause_pointer_push(clause, &(lit->clauses), &(lit->num_clauses), &(lit->dyn_cap));
-    var = sat_literal_var(lit);
+    var = sat_state->variables[code_var(clause->lits[i])];
     clause_pointer_push(clause, &(var->clauses), &(var->num_clauses), &(var->dyn_cap));
   }
 }
 
+// starts watching lits[0] and lits[1] of the clause; a binary clause goes to the implication
+// lists of its literals instead
+void watch_clause(Clause* clause, SatState* sat_state) {
+  if (clause->size < 2) return;
+  if (clause->size == 2) {
+    implication_push(clause->lits[1], &(sat_state->implications[clause->lits[0]]));
+    implication_push(clause->lits[0], &(sat_state->implications[clause->lits[1]]));
+    return;
+  }
+  ClauseList* w0 = &(sat_state->watches[clause->lits[0]]);
+  ClauseList* w1 = &(sat_state->watches[clause->lits[1]]);
+  clause_pointer_push(clause, &(w0->clauses), &(w0->size), &(w0->cap));
+  clause_pointer_push(clause, &(w1->clauses), &(w1->size), &(w1->cap));
+}
+
 /******************************************************************************
  * Variables
  ******************************************************************************/
 
-Var* new_variable(c2dSize index) {
+Var* new_variable(c2dSize index, c2dSize cap) {
   Var* new_v = malloc(sizeof(Var));
   new_v->index = index;
   new_v->num_clauses = 0;
-  new_v->dyn_cap = 2;
+  new_v->dyn_cap = cap < 2 ? 2 : cap;
   new_v->clauses = malloc(sizeof(Clause*) * new_v->dyn_cap);
   new_v->p_literal = NULL;
   new_v->n_literal = NULL;
@@ -126,13 +154,23 @@ Var* sat_literal_var(const Lit* lit) {
 //returns 1 if the variable is instantiated, 0 otherwise
 //a variable is instantiated either by decision or implication (by unit resolution)
 BOOLEAN sat_instantiated_var(const Var* var) {
-  return sat_implied_literal(var->p_literal) | sat_implied_literal(var->n_literal);
+  return var->p_literal->sat_state->levels[var->index] > 0;
+}
+
+// returns 1 if one of the literals of the clause is true
+static inline BOOLEAN clause_subsumed(const Clause* clause, const SatState* sat_state) {
+  for (c2dSize i = 0; i < clause->size; i++) {
+    if (sat_state->values[clause->lits[i]] > 0) return 1;
+  }
+  return 0;
 }
 
 //returns 1 if all the clauses mentioning the variable are subsumed, 0 otherwise
 BOOLEAN sat_irrelevant_var(const Var* var) {
+  const SatState* sat_state = var->p_literal->sat_state;
+  if (sat_state->occurrences != NULL) return sat_state->unsubsumed_counts[var->index] == 0;
   for (c2dSize i = 0; i < sat_var_occurences(var); i++) {
-    if (!sat_subsumed_clause(var->clauses[i]))
+    if (!clause_subsumed(var->clauses[i], sat_state))
       return 0;
   }
   return 1;
@@ -149,55 +187,55 @@ c2dSize sat_var_occurences(const Var* var) {
   return var->num_cnf_clauses;
 }
 
+Lit** clause_literal_views(Clause* clause, const SatState* sat_state);
+
 //returns the index^th clause that mentions a variable
 //index starts from 0, and is less than the number of clauses mentioning the variable
 //this cannot be called on a variable that is not mentioned by any clause
 Clause* sat_clause_of_var(c2dSize index, const Var* var) {
+  clause_literal_views(var->clauses[index], var->p_literal->sat_state);
   return var->clauses[index];
 }
 
 /******************************************************************************
- * Literals 
+ * Literals
  ******************************************************************************/
 
-void instantiate_literal(Lit* lit, c2dLiteral decision_level, Clause* decision_clause) {
-  lit->decision_level = decision_level;
-  lit->decision_clause = decision_clause;
+// sets the literal and pushes it to the propagation queue
+// clauses are not touched here, they are visited through the watches in propagate()
+static inline void instantiate_literal(c2dLitCode lit, c2dSize decision_level,
+                                       Clause* decision_clause, SatState* sat_state) {
+  c2dSize var = code_var(lit);
+  sat_state->values[lit] = 1;
+  sat_state->values[code_op(lit)] = -1;
+  sat_state->levels[var] = decision_level;
+  sat_state->reasons[var] = decision_clause;
+  sat_state->trail[sat_state->trail_size++] = lit;
+  if (sat_state->occurrences != NULL) subsumption_assigned(lit, sat_state);
+}
 
-  for (c2dSize i = 0; i < lit->num_clauses; i++) {
-    if (lit->clauses[i]->decision_level == 0 ||
-        lit->clauses[i]->decision_level > decision_level) {
-      lit->clauses[i]->decision_level = decision_level;
-    }
-  }
-  for (c2dSize i = 0; i < lit->op_lit->num_clauses; i++) {
-    ++lit->op_lit->clauses[i]->num_false;
-  }
+static inline void undo_instantiate_literal(c2dLitCode lit, SatState* sat_state) {
+  c2dSize var = code_var(lit);
+  if (sat_state->occurrences != NULL) subsumption_unassigned(lit, sat_state);
+  sat_state->values[lit] = 0;
+  sat_state->values[code_op(lit)] = 0;
+  sat_state->levels[var] = 0;
+  sat_state->reasons[var] = NULL;
+  sat_state->phases[var] = (lit & 1) ? -1 : 1;
+  var_heap_insert(&(sat_state->order), var, sat_state->activity);
 }
 
-void undo_instantiate_literal(Lit* lit) {
-  for (c2dSize i = 0; i < lit->num_clauses; i++) {
-    if (lit->clauses[i]->decision_level == lit->decision_level) {
-      lit->clauses[i]->decision_level = 0;
-    }
-  }
-  for (c2dSize i = 0; i < lit->op_lit->num_clauses; i++) {
-    --lit->op_lit->clauses[i]->num_false;
-  }
-  lit->decision_level = 0;
-  lit->decision_clause = NULL;
+// literals which are not false come first, then false literals from the highest level
+static inline c2dSize watch_priority(c2dLitCode lit, const SatState* sat_state) {
+  return sat_state->values[lit] < 0 ? sat_state->levels[code_var(lit)] : (c2dSize)-1;
 }
 
-Lit* new_literal(c2dLiteral index, Var* var) {
+Lit* new_literal(c2dLiteral index, Var* var, const SatState* sat_state) {
   Lit* new_lit= malloc(sizeof(Lit));
   new_lit->index = index;
+  new_lit->code = lit_code(index);
   new_lit->var = var;
-  new_lit->decision_level = 0;
-  new_lit->decision_clause = NULL;
-
-  new_lit->num_clauses = 0;
-  new_lit->dyn_cap = 2;
-  new_lit->clauses = malloc(sizeof(Clause*) * new_lit->dyn_cap);
+  new_lit->sat_state = sat_state;
   return new_lit;
 }
 
@@ -210,6 +248,11 @@ Lit* sat_index2literal(c2dLiteral index, const SatState* sat_state) {
   }
 }
 
+// returns the literal structure of a literal code
+static inline Lit* code2literal(c2dLitCode code, const SatState* sat_state) {
+  return (code & 1) ? sat_state->n_literals[code >> 1] : sat_state->p_literals[code >> 1];
+}
+
 //returns the index of a literal
 c2dLiteral sat_literal_index(const Lit* lit) {
   return lit->index;
@@ -225,35 +268,73 @@ Lit* sat_neg_literal(const Var* var) {
   return var->n_literal;
 }
 
+//returns the weight of a literal given by the cnf (1 if it has none)
+c2dWmc sat_literal_weight(const Lit* lit) {
+  return lit->sat_state->weights[lit->code];
+}
+
 //returns 1 if the literal is implied, 0 otherwise
 //a literal is implied by deciding its variable, or by inference using unit resolution
 BOOLEAN sat_implied_literal(const Lit* lit) {
-  return lit->decision_level > 0;
+  return lit->sat_state->values[lit->code] > 0;
+}
+
+//returns the literal to decide next: the free variable with the highest activity, set
+//to the value it had last (negative if it has never been set)
+//returns NULL if all variables are instantiated
+Lit* sat_next_decision(SatState* sat_state) {
+  c2dSize var;
+  do {
+    var = var_heap_pop(&(sat_state->order), sat_state->activity);
+    if (var == 0) return NULL;
+  } while (sat_state->levels[var] != 0 || sat_state->eliminated[var]);
+  return sat_state->phases[var] > 0 ? sat_state->p_literals[var] : sat_state->n_literals[var];
+}
+
+// xorshift64*, enough to diversify searches
+static inline unsigned long long next_random(unsigned long long* state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 2685821657736338717ULL;
+}
+
+//diversifies the search of sat state from the given seed: the variables get random initial
+//phases, and a small random activity which breaks the ties of the decision heuristic
+void sat_set_seed(SatState* sat_state, unsigned long seed) {
+  unsigned long long random = 0x9E3779B97F4A7C15ULL * (seed + 1);
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
+    unsigned long long r = next_random(&random);
+    if (sat_state->phases[i] == 0) sat_state->phases[i] = (r & 1) ? 1 : -1;
+    sat_state->activity[i] += (double)(r >> 11) * 0x1.0p-53 * 1e-3 * sat_state->var_inc;
+    var_heap_increased(&(sat_state->order), i, sat_state->activity);
+  }
 }
 
 //sets the literal to true, and then runs unit resolution
 //returns a learned clause if unit resolution detected a contradiction, NULL otherwise
 //
-//if the current decision level is L in the beginning of the call, it should be updated 
+//if the current decision level is L in the beginning of the call, it should be updated
 //to L+1 so that the decision level of lit and all other literals implied by unit resolution is L+1
 Clause* sat_decide_literal(Lit* lit, SatState* sat_state) {
-  instantiate_literal(lit, ++sat_state->cur_level, NULL);
-  sat_state->decided_literals[sat_state->num_decided_literals++] = lit;
+  instantiate_literal(lit->code, ++sat_state->cur_level, NULL, sat_state);
+  ++sat_state->num_decisions;
+  sat_state->decided_literals[sat_state->num_decided_literals++] = lit->code;
 
   sat_state->unit_resolution_s = UNIT_RESOLUTION_AFTER_DECIDING_LITERAL;
   sat_unit_resolution(sat_state);
+  SAT_STAT(if (sat_state->trail_size > sat_state->max_trail_size) sat_state->max_trail_size = sat_state->trail_size);
 
   return sat_state->asserted_clause;
 }
 
 //undoes the last literal decision and the corresponding implications obtained by unit resolution
 //
-//if the current decision level is L in the beginning of the call, it should be updated 
+//if the current decision level is L in the beginning of the call, it should be updated
 //to L-1 before the call ends
 void sat_undo_decide_literal(SatState* sat_state) {
   c2dSize sz = sat_state->num_decided_literals;
-  while (sz > 0 && sat_state->decided_literals[sz - 1]->decision_level == sat_state->cur_level) {
-    undo_instantiate_literal(sat_state->decided_literals[sz - 1]);
+  while (sz > 0 && sat_state->levels[code_var(sat_state->decided_literals[sz - 1])] == sat_state->cur_level) {
     --sz;
   }
   sat_state->num_decided_literals = sz;
@@ -261,29 +342,238 @@ void sat_undo_decide_literal(SatState* sat_state) {
   --sat_state->cur_level;
 }
 
+// sets a literal at the current level without a reason, for the variables which do not take
+// part in the search (see extend_model())
+void assign_literal(c2dLitCode lit, SatState* sat_state) {
+  instantiate_literal(lit, sat_state->cur_level, NULL, sat_state);
+  sat_state->trail_head = sat_state->binary_head = sat_state->trail_size;
+}
+
+//undoes every decision made above the given level, and the corresponding implications,
+//in one pass over the trail; the decision level of the sat state becomes level
+void sat_backtrack_to_level(c2dSize level, SatState* sat_state) {
+  if (level >= sat_state->cur_level) return;
+  SAT_TRACE_BEGIN(TRACE_UNDO);
+  c2dSize sz = sat_state->trail_size;
+  while (sz > 0 && sat_state->levels[code_var(sat_state->trail[sz - 1])] > level) {
+    undo_instantiate_literal(sat_state->trail[--sz], sat_state);
+  }
+  sat_state->trail_size = sz;
+  sat_state->trail_head = sz;
+  sat_state->binary_head = sz;
+
+  sz = sat_state->num_decided_literals;
+  while (sz > 0 && sat_state->levels[code_var(sat_state->decided_literals[sz - 1])] == 0) --sz;
+  sat_state->num_decided_literals = sz;
+  sat_state->cur_level = level;
+  SAT_TRACE_END(TRACE_UNDO);
+}
+
 /******************************************************************************
- * Clauses 
+ * Clauses
  ******************************************************************************/
 
-Clause* new_clause(c2dSize index, c2dSize clause_size, Lit **buf_lit) {
-  Clause* new_c = malloc(sizeof(Clause));
+// returns a clause allocated in arena with the given index and literal codes
+static Clause* new_clause(ClauseArena* arena, c2dSize index, c2dSize clause_size, const c2dLitCode* buf_lit) {
+  Clause* new_c = clause_arena_alloc(arena, clause_size);
   new_c->index = index;
-  new_c->size = clause_size;
-  new_c->literals = malloc(sizeof(Lit*) * clause_size);
+  new_c->relocated = 0;
 
-  new_c->num_false = 0;
-  new_c->decision_level = 0;
-
-  for (c2dSize i = 0; i < clause_size; i++)
-    new_c->literals[i] = buf_lit[i];
+  for (c2dSize i = 0; i < clause_size && buf_lit != NULL; i++)
+    new_c->lits[i] = buf_lit[i];
 
   new_c->assertion_level = 0;
+  new_c->lbd = 0;
+  new_c->activity = 0;
+  new_c->deleted = 0;
   new_c->mark = 0;
   return new_c;
 }
 
+// builds the literals array of the clause, which is only needed by the users of the API
+Lit** clause_literal_views(Clause* clause, const SatState* sat_state) {
+  if (clause->literals == NULL) {
+    clause->literals = malloc(sizeof(Lit*) * (clause->size + 1));
+    for (c2dSize i = 0; i < clause->size; i++)
+      clause->literals[i] = code2literal(clause->lits[i], sat_state);
+  }
+  return clause->literals;
+}
+
+static inline void release_literal_views(Clause* clause) {
+  free(clause->literals);
+  clause->literals = NULL;
+}
+
+// follows the forwarding pointer left by collect_learned_clauses()
+static inline Clause* relocated_clause(Clause* clause) {
+  return clause->relocated ? (Clause*)clause->literals : clause;
+}
+
+static void relocate_clause_list(Clause** clauses, c2dSize num_clauses) {
+  for (c2dSize i = 0; i < num_clauses; i++) clauses[i] = relocated_clause(clauses[i]);
+}
+
+// copies a learned clause into the arena, leaving a forwarding pointer in the old copy
+static Clause* move_clause(Clause* old_c, ClauseArena* to) {
+  Clause* new_c = clause_arena_alloc(to, old_c->size);
+  memcpy(new_c, old_c, clause_arena_bytes(old_c->size));
+  old_c->relocated = 1;
+  old_c->literals = (Lit**)new_c;
+  return new_c;
+}
+
+// compacts the learned clauses into a new arena, and updates every list
+// referring to them. *clause is updated as well if it is a learned clause
+void collect_learned_clauses(SatState* sat_state, Clause** clause) {
+  ClauseArena* from = &(sat_state->learned_arena);
+  ClauseArena to;
+  clause_arena_init(&to, from->live > LEARNED_ARENA_BLOCK ? from->live : LEARNED_ARENA_BLOCK);
+
+  for (c2dSize i = 0; i < sat_state->num_learned_clauses; i++) {
+    sat_state->learned_clauses[i] = move_clause(sat_state->learned_clauses[i], &to);
+  }
+  // a clause derived from the last conflict but not asserted yet is in no list
+  Clause* asserted = sat_state->asserted_clause;
+  if (asserted != NULL && asserted->index == 0 && !asserted->relocated) move_clause(asserted, &to);
+
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
+    relocate_clause_list(sat_state->watches[2 * i].clauses, sat_state->watches[2 * i].size);
+    relocate_clause_list(sat_state->watches[2 * i + 1].clauses, sat_state->watches[2 * i + 1].size);
+  }
+  for (c2dSize i = 0; i < sat_state->trail_size; i++) {
+    c2dSize var = code_var(sat_state->trail[i]);
+    Clause* reason = sat_state->reasons[var];
+    if (reason != NULL && !is_binary_reason(reason)) sat_state->reasons[var] = relocated_clause(reason);
+  }
+  if (*clause != NULL) *clause = relocated_clause(*clause);
+  if (sat_state->asserted_clause != NULL) {
+    sat_state->asserted_clause = relocated_clause(sat_state->asserted_clause);
+  }
+
+  clause_arena_release(from);
+  *from = to;
+}
+
+/******************************************************************************
+ * Learned clause database
+ *
+ * Learned clauses are scored by their lbd (the number of distinct decision levels
+ * among their literals, lower is better) and by their activity (how recently they
+ * took part in conflicts). Periodically, the worse half is deleted: the clauses are
+ * removed from the watch lists, and their memory is reclaimed by compacting the arena.
+ ******************************************************************************/
+
+//makes room in the arrays indexed by decision level for the levels below num_levels
+void reserve_levels(c2dSize num_levels, SatState* sat_state) {
+  if (num_levels <= sat_state->num_level_stamps) return;
+  sat_state->level_stamps = realloc(sat_state->level_stamps, sizeof(c2dSize) * num_levels);
+  memset(sat_state->level_stamps + sat_state->num_level_stamps, 0,
+         sizeof(c2dSize) * (num_levels - sat_state->num_level_stamps));
+  sat_state->num_level_stamps = num_levels;
+}
+
+// returns the number of distinct decision levels among the literals of the clause
+unsigned int clause_lbd(const c2dLitCode* lits, c2dSize size, SatState* sat_state) {
+  unsigned int lbd = 0;
+  ++sat_state->stamp;
+  for (c2dSize i = 0; i < size; i++) {
+    c2dSize level = sat_state->levels[code_var(lits[i])];
+    if (sat_state->level_stamps[level] != sat_state->stamp) {
+      sat_state->level_stamps[level] = sat_state->stamp;
+      ++lbd;
+    }
+  }
+  return lbd;
+}
+
+void bump_clause_activity(Clause* clause, SatState* sat_state) {
+  clause->activity += sat_state->clause_inc;
+  if (clause->activity > 1e20f) {
+    for (c2dSize i = 0; i < sat_state->num_learned_clauses; i++) {
+      sat_state->learned_clauses[i]->activity *= 1e-20f;
+    }
+    sat_state->clause_inc *= 1e-20f;
+  }
+}
+
+// returns 1 if the clause is the reason of an instantiated literal
+static inline BOOLEAN locked_clause(const Clause* clause, const SatState* sat_state) {
+  return clause->size > 0 && sat_state->values[clause->lits[0]] > 0 &&
+         sat_state->reasons[code_var(clause->lits[0])] == clause;
+}
+
+// worse clauses first: higher lbd, then lower activity
+static int compare_learned_clauses(const void* a, const void* b) {
+  const Clause* x = *(Clause* const*)a;
+  const Clause* y = *(Clause* const*)b;
+  if (x->lbd != y->lbd) return x->lbd > y->lbd ? -1 : 1;
+  if (x->activity != y->activity) return x->activity < y->activity ? -1 : 1;
+  return 0;
+}
+
+static void remove_deleted_clauses(ClauseList* list) {
+  c2dSize j = 0;
+  for (c2dSize i = 0; i < list->size; i++) {
+    if (!list->clauses[i]->deleted) list->clauses[j++] = list->clauses[i];
+  }
+  list->size = j;
+}
+
+void sat_set_reduce_schedule(SatState* sat_state, c2dSize first, c2dSize inc) {
+  sat_state->reduce_first = first;
+  sat_state->reduce_inc = inc;
+  sat_state->next_reduce = sat_state->num_conflicts + first + sat_state->num_reductions * inc;
+}
+
+void sat_reduce_learned_clauses(SatState* sat_state) {
+  c2dSize num_learned = sat_state->num_learned_clauses;
+  Clause** learned = sat_state->learned_clauses;
+
+  // Clauses which are the reason of a literal are kept, whatever their score
+  qsort(learned, num_learned, sizeof(Clause*), compare_learned_clauses);
+  c2dSize num_deleted = 0;
+  for (c2dSize i = 0; i < num_learned && num_deleted < num_learned / 2; i++) {
+    if (learned[i]->lbd > 2 && learned[i]->size > 2 && !locked_clause(learned[i], sat_state)) {
+      learned[i]->deleted = 1;
+      ++num_deleted;
+    }
+  }
+
+  if (num_deleted > 0) {
+    for (c2dSize i = 0; i < 2 * (sat_state->num_vars + 1); i++) {
+      remove_deleted_clauses(&(sat_state->watches[i]));
+    }
+
+    // The remaining clauses keep their relative order, and are renumbered
+    c2dSize j = 0;
+    for (c2dSize i = 0; i < num_learned; i++) {
+      if (learned[i]->deleted) {
+        release_literal_views(learned[i]);
+        clause_arena_free(&(sat_state->learned_arena), learned[i]);
+      } else {
+        learned[j] = learned[i];
+        learned[j]->index = sat_state->num_cnf_clauses + j + 1;
+        ++j;
+      }
+    }
+    sat_state->num_learned_clauses = j;
+    sat_state->num_deleted_clauses += num_deleted;
+
+    ClauseArena* arena = &(sat_state->learned_arena);
+    if (arena->wasted >= LEARNED_ARENA_BLOCK && arena->wasted > arena->live) {
+      Clause* none = NULL;
+      collect_learned_clauses(sat_state, &none);
+    }
+  }
+
+  ++sat_state->num_reductions;
+  sat_state->next_reduce = sat_state->num_conflicts + sat_state->reduce_first +
+                           sat_state->num_reductions * sat_state->reduce_inc;
+}
+
 //returns a clause structure for the corresponding index
-Clause* sat_index2clause(c2dSize index, const SatState* sat_state) {
+static inline Clause* index2clause(c2dSize index, const SatState* sat_state) {
   if (index <= sat_state->num_cnf_clauses) {
     return sat_state->cnf_clauses[index];
   } else {
@@ -291,6 +581,12 @@ Clause* sat_index2clause(c2dSize index, const SatState* sat_state) {
   }
 }
 
+Clause* sat_index2clause(c2dSize index, const SatState* sat_state) {
+  Clause* clause = index2clause(index, sat_state);
+  clause_literal_views(clause, sat_state);
+  return clause;
+}
+
 //returns the index of a clause
 c2dSize sat_clause_index(const Clause* clause) {
   return clause->index;
@@ -303,12 +599,19 @@ Lit** sat_clause_literals(const Clause* clause) {
 
 //returns the number of literals in a clause
 c2dSize sat_clause_size(const Clause* clause) {
-  return clause->size; 
+  return clause->size;
 }
 
 //returns 1 if the clause is subsumed, 0 otherwise
 BOOLEAN sat_subsumed_clause(const Clause* clause) {
-  return clause->decision_level > 0;
+  // the sat state is only reachable through the literals array
+  if (clause->size == 0 || clause->literals == NULL) return 0;
+  const SatState* sat_state = clause->literals[0]->sat_state;
+  if (sat_state->occurrences != NULL && clause->index >= 1 && clause->index <= sat_state->num_cnf_clauses &&
+      sat_state->cnf_clauses[clause->index] == clause) {
+    return sat_state->true_counts[clause->index] > 0;
+  }
+  return clause_subsumed(clause, sat_state);
 }
 
 //returns the number of clauses in the cnf of sat state
@@ -321,32 +624,43 @@ c2dSize sat_learned_clause_count(const SatState* sat_state) {
   return sat_state->num_learned_clauses;
 }
 
+// moves the literals which are not false to the front, and otherwise the false literals
+// set at the highest levels, so that the watches stay valid after backtracking
+static void order_watches(Clause* clause, const SatState* sat_state) {
+  c2dLitCode* lits = clause->lits;
+  c2dLitCode tmp;
+  for (c2dSize w = 0; w < 2 && w < clause->size; w++) {
+    for (c2dSize i = w + 1; i < clause->size; i++) {
+      if (watch_priority(lits[i], sat_state) > watch_priority(lits[w], sat_state)) {
+        tmp = lits[w], lits[w] = lits[i], lits[i] = tmp;
+      }
+    }
+  }
+}
+
 //adds clause to the set of learned clauses, and runs unit resolution
 //returns a learned clause if unit resolution finds a contradiction, NULL otherwise
 //
 //this function is called on a clause returned by sat_decide_literal() or sat_assert_clause()
 //moreover, it should be called only if sat_at_assertion_level() succeeds
 Clause* sat_assert_clause(Clause* clause, SatState* sat_state) {
-  // Update the num_false and decision_level
-  for (c2dSize i = 0; i < clause->size; i++) {
-    if (clause->literals[i]->decision_level > 0) {
-      if (clause->decision_level == 0 || clause->literals[i]->decision_level < clause->decision_level)
-        clause->decision_level = clause->literals[i]->decision_level;
-    } else 
-    if (clause->literals[i]->op_lit->decision_level > 0) {
-      clause->num_false ++;
-    }
-  }
+  order_watches(clause, sat_state);
+  release_literal_views(clause);
 
   // Push the clause to learned_clauses list and update the index
   clause_pointer_push(clause, &(sat_state->learned_clauses), &(sat_state->num_learned_clauses), &(sat_state->dyn_cap));
   clause->index = sat_state->num_cnf_clauses + sat_state->num_learned_clauses;
 
-  // Update the clauses mentioning list of the variables involing.
-  push_clause_to_vars(clause);
+  // Learned clauses are not added to the occurrence lists, which only hold cnf clauses
+  watch_clause(clause, sat_state);
 
   sat_state->unit_resolution_s = UNIT_RESOLUTION_AFTER_ASSERTING_CLAUSE;
   sat_unit_resolution(sat_state);
+
+  // the clause is now the reason of its asserted literal, so the reduction keeps it
+  if (sat_state->reduce_first > 0 && sat_state->num_conflicts >= sat_state->next_reduce) {
+    sat_reduce_learned_clauses(sat_state);
+  }
   return sat_state->asserted_clause;
 }
 
@@ -358,7 +672,7 @@ Clause* sat_assert_clause(Clause* clause, SatState* sat_state) {
  *
  * This construction will depend on how you define a SatState
  * Still, you should at least do the following:
- * --read a cnf (in DIMACS format, possible with weights) from the file
+ * --read a cnf (in DIMACS format, possibly with weights) from the file
  * --initialize variables (n of them)
  * --initialize literals  (2n of them)
  * --initialize clauses   (m of them)
@@ -370,99 +684,256 @@ Clause* sat_assert_clause(Clause* clause, SatState* sat_state) {
  * SatState (sat_state_free)
  ******************************************************************************/
 
-char* skip_a_string(char *p) {
-  while (*p && (*p == ' ' || *p == (char)(9))) ++p;
-  while (*p && *p != ' ' && *p != (char)(9)) ++p;
-  return p;
+// builds the sat state of a cnf read by one of the dimacs_read functions
+static SatState* sat_state_new_from_read(DimacsCnf* cnf, double start) {
+  if (cnf == NULL) return NULL;
+  SatState* state = sat_state_new_from_cnf(cnf);
+  dimacs_free(cnf);
+  state->parse_time = sat_clock() - start;
+  return state;
 }
 
-char* read_an_interger(char *p, c2dLiteral *num) {
-  while (*p && (*p == ' ' || *p == (char)(9))) ++p;
-  c2dLiteral ret = 0, sign = 1;
-  if (*p == '-') sign = -1, ++p;
-  while ('0' <= *p && *p <= '9') {
-    ret = ret * 10 + ((*p) - '0');
-    ++p;
+//constructs a SatState from an input cnf file
+SatState* sat_state_new(const char* file_name) {
+  double start = sat_clock();
+  DimacsCnf* cnf = dimacs_read_file(file_name);
+  if (cnf == NULL) {
+    fprintf(stderr, "%s: cannot read cnf\n", file_name);
+    return NULL;
   }
-  *num = sign * ret;
-  return p;
+  return sat_state_new_from_read(cnf, start);
 }
 
-//constructs a SatState from an input cnf file
-SatState* sat_state_new(const char* file_name) {
-  SatState* state = malloc(sizeof(SatState));
-  c2dLiteral tmp_num;
-
-  FILE *file = fopen(file_name, "r");
-  char *line = (char*)malloc(BUF_LEN * sizeof(char));
-  char *line_start_p = line;
-
-  Lit **buf_literals;
-  c2dSize cur_clause_index = 0;
-  while (fgets(line, BUF_LEN, file)) {
-    if (strlen(line) < 2) continue;
-    if (line[0] == 'c' || line[0] == '%' || line[0] == '0') continue;
-    if (line[0] == 'p') {
-      line = skip_a_string(skip_a_string(line));
-      line = read_an_interger(line, &tmp_num);
-      state->num_vars = (c2dSize)tmp_num;
-      line = read_an_interger(line, &tmp_num);
-      state->num_cnf_clauses = (c2dSize)tmp_num;
-      state->variables = malloc(sizeof(Var*) * (state->num_vars+1));
-      state->p_literals = malloc(sizeof(Lit*) * (state->num_vars+1));
-      state->n_literals = malloc(sizeof(Lit*) * (state->num_vars+1));
-      for (c2dSize i = 1; i <= state->num_vars; i++) {
-        state->variables[i] = new_variable(i);
-        state->variables[i]->p_literal = state->p_literals[i] = new_literal((c2dLiteral)i, state->variables[i]);
-        state->variables[i]->n_literal = state->n_literals[i] = new_literal(-((c2dLiteral)i), state->variables[i]);
-        state->p_literals[i]->op_lit = state->n_literals[i];
-        state->n_literals[i]->op_lit = state->p_literals[i]; 
-      }
-      state->cnf_clauses = malloc(sizeof(Clause*) * (state->num_cnf_clauses + 1));
-      buf_literals = malloc(sizeof(Lit*) * 2 * state->num_vars);
-    } else {
-      c2dSize clause_size = 0;
-      while ((line = read_an_interger(line, &tmp_num))) {
-        if (tmp_num == 0) break;
-        if (tmp_num > 0) {
-          buf_literals[clause_size++] = state->p_literals[tmp_num];
-        } else {
-          buf_literals[clause_size++] = state->n_literals[-tmp_num];
-        }
-      }
-      if (clause_size > 0) {
-        ++cur_clause_index;
-        state->cnf_clauses[cur_clause_index] = new_clause(cur_clause_index, clause_size, buf_literals);
-        push_clause_to_vars(state->cnf_clauses[cur_clause_index]);
-        if (cur_clause_index == state->num_cnf_clauses) break;
-      }
-    }
-    line = line_start_p;
+//constructs a SatState from a cnf read from an open file descriptor or stream, e.g. a pipe
+SatState* sat_state_new_from_fd(int fd) {
+  double start = sat_clock();
+  return sat_state_new_from_read(dimacs_read_fd(fd), start);
+}
+
+SatState* sat_state_new_from_stream(FILE* file) {
+  double start = sat_clock();
+  return sat_state_new_from_read(dimacs_read_stream(file), start);
+}
+
+//constructs a SatState from a parsed cnf, which is not modified
+//
+// builds the cnf clauses from their literal codes (each clause terminated by 0), and adds
+// them to the occurrence lists and the watches
+static void load_cnf_clauses(SatState* state, const c2dLitCode* codes, c2dSize arena_bytes) {
+  clause_arena_init(&(state->cnf_arena), arena_bytes);
+  for (c2dSize i = 1; i <= state->num_cnf_clauses; i++) {
+    c2dSize clause_size = 0;
+    while (codes[clause_size] != 0) ++clause_size;
+    state->cnf_clauses[i] = new_clause(&(state->cnf_arena), i, clause_size, codes);
+    push_clause_to_vars(state->cnf_clauses[i], state);
+    watch_clause(state->cnf_clauses[i], state);
+    codes += clause_size + 1;
   }
-  fclose(file);
-  free(line_start_p);
-  free(buf_literals);
 
   for (c2dSize i = 1; i <= state->num_vars; i++) {
     state->variables[i]->num_cnf_clauses = state->variables[i]->num_clauses;
   }
+}
+
+// replaces the cnf clauses of a sat state which has not been used yet, e.g. by the clauses
+// left by the preprocessor; codes are in the format of load_cnf_clauses()
+void replace_cnf_clauses(SatState* sat_state, const c2dLitCode* codes, c2dSize num_clauses) {
+  for (c2dSize i = 1; i <= sat_state->num_cnf_clauses; i++) {
+    release_literal_views(sat_state->cnf_clauses[i]);
+  }
+  clause_arena_release(&(sat_state->cnf_arena));
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) sat_state->variables[i]->num_clauses = 0;
+  for (c2dSize i = 0; i < 2 * (sat_state->num_vars + 1); i++) {
+    sat_state->watches[i].size = 0;
+    sat_state->implications[i].size = 0;
+  }
+
+  c2dSize arena_bytes = 0;
+  for (c2dSize i = 0, clause_start = 0, n = 0; n < num_clauses; i++) {
+    if (codes[i] != 0) continue;
+    arena_bytes += clause_arena_bytes(i - clause_start);
+    clause_start = i + 1;
+    ++n;
+  }
+
+  sat_state->num_cnf_clauses = num_clauses;
+  if (num_clauses + 1 > sat_state->cnf_cap) {
+    sat_state->cnf_cap = num_clauses + 1;
+    sat_state->cnf_clauses = realloc(sat_state->cnf_clauses, sizeof(Clause*) * sat_state->cnf_cap);
+  }
+  load_cnf_clauses(sat_state, codes, arena_bytes);
+  subsumption_clauses_replaced(sat_state);
+}
+
+//all lists are sized from the occurrence counts of the cnf, so nothing is reallocated here
+SatState* sat_state_new_from_cnf(const DimacsCnf* cnf) {
+  double start = sat_clock();
+  SatState* state = malloc(sizeof(SatState));
+  state->num_vars = cnf->num_vars;
+  state->num_cnf_clauses = cnf->num_clauses;
+
+  state->variables = malloc(sizeof(Var*) * (state->num_vars+1));
+  state->p_literals = malloc(sizeof(Lit*) * (state->num_vars+1));
+  state->n_literals = malloc(sizeof(Lit*) * (state->num_vars+1));
+  for (c2dSize i = 1; i <= state->num_vars; i++) {
+    state->variables[i] = new_variable(i, cnf->occurrences[i] + 1);
+    state->variables[i]->p_literal = state->p_literals[i] = new_literal((c2dLiteral)i, state->variables[i], state);
+    state->variables[i]->n_literal = state->n_literals[i] = new_literal(-((c2dLiteral)i), state->variables[i], state);
+    state->p_literals[i]->op_lit = state->n_literals[i];
+    state->n_literals[i]->op_lit = state->p_literals[i];
+  }
+
+  // Counts the clauses watching each literal (binary ones separately), and the memory taken
+  // by the clauses
+  c2dSize num_codes = 2 * (state->num_vars + 1);
+  c2dSize* num_watches = calloc(num_codes, sizeof(c2dSize));
+  c2dSize* num_binaries = calloc(num_codes, sizeof(c2dSize));
+  c2dSize arena_bytes = 0;
+  for (c2dSize i = 0, clause_start = 0; i < cnf->num_codes; i++) {
+    if (cnf->codes[i] != 0) continue;
+    c2dSize* counts = i - clause_start == 2 ? num_binaries : num_watches;
+    if (i - clause_start >= 2) {
+      ++counts[cnf->codes[clause_start]];
+      ++counts[cnf->codes[clause_start + 1]];
+    }
+    arena_bytes += clause_arena_bytes(i - clause_start);
+    clause_start = i + 1;
+  }
+
+  state->values = calloc(num_codes, sizeof(BOOLEAN));
+  state->weights = malloc(sizeof(c2dWmc) * num_codes);
+  for (c2dSize i = 0; i < num_codes; i++) {
+    state->weights[i] = cnf->weights == NULL ? wmc_one() : wmc_from_weight(cnf->weights[i]);
+  }
+  state->levels = calloc(state->num_vars + 1, sizeof(c2dSize));
+  state->reasons = calloc(state->num_vars + 1, sizeof(Clause*));
+  state->watches = malloc(sizeof(ClauseList) * num_codes);
+  state->implications = malloc(sizeof(ImplicationList) * num_codes);
+  for (c2dSize i = 0; i < num_codes; i++) {
+    state->watches[i].size = 0;
+    state->watches[i].cap = num_watches[i] + 2;
+    state->watches[i].clauses = malloc(sizeof(Clause*) * state->watches[i].cap);
+    state->implications[i].size = 0;
+    state->implications[i].cap = num_binaries[i] + 2;
+    state->implications[i].lits = malloc(sizeof(c2dLitCode) * state->implications[i].cap);
+  }
+  free(num_watches);
+  free(num_binaries);
+
+  // Not part of any arena, derive_asserted_clause() only reads its literals
+  state->binary_conflict = malloc(clause_arena_bytes(2));
+  memset(state->binary_conflict, 0, clause_arena_bytes(2));
+  state->binary_conflict->size = 2;
+
+  state->cnf_cap = state->num_cnf_clauses + 1;
+  state->cnf_clauses = malloc(sizeof(Clause*) * state->cnf_cap);
+  load_cnf_clauses(state, cnf->codes, arena_bytes);
+
   state->cur_level = 1;
   state->dyn_cap = 2;
   state->num_learned_clauses = 0;
   state->learned_clauses = malloc(sizeof(Clause*) * state->dyn_cap);
-  
+  clause_arena_init(&(state->learned_arena), LEARNED_ARENA_BLOCK);
+
+  state->num_conflicts = 0;
+  state->reduce_first = REDUCE_FIRST;
+  state->reduce_inc = REDUCE_INC;
+  state->next_reduce = REDUCE_FIRST;
+  state->num_reductions = 0;
+  state->num_deleted_clauses = 0;
+  state->clause_inc = 1;
+  state->num_level_stamps = state->num_vars + 2;
+  state->level_stamps = calloc(state->num_level_stamps, sizeof(c2dSize));
+  state->stamp = 0;
+
   state->num_decided_literals = 0;
-  state->decided_literals = malloc(state->num_vars * 2 * sizeof(Lit*));
-  state->num_implied_literals = 0;
-  state->implied_literals = malloc(state->num_vars * 2 * sizeof(Lit*));
-  
+  state->decided_literals = malloc(state->num_vars * 2 * sizeof(c2dLitCode));
+  state->trail_size = 0;
+  state->trail_head = 0;
+  state->binary_head = 0;
+  state->trail = malloc(state->num_vars * 2 * sizeof(c2dLitCode));
+
   state->unit_resolution_s = UNIT_RESOLUTION_FIRST_TIME;
+  state->asserted_clause = NULL;
+
+  state->activity = calloc(state->num_vars + 1, sizeof(double));
+  state->var_inc = 1;
+  state->phases = calloc(state->num_vars + 1, sizeof(BOOLEAN));
+  var_heap_init(&(state->order), state->num_vars);
+  for (c2dSize i = 1; i <= state->num_vars; i++) var_heap_insert(&(state->order), i, state->activity);
+
+  state->num_restarts = 0;
+  sat_set_restart_policy(state, RESTART_GLUCOSE);
+
+  state->num_decisions = 0;
+  sat_set_solve_limits(state, 0, 0, 0);
+  state->inconsistent = 0;
+  state->interrupt = NULL;
+  state->exchange = NULL;
+  state->exchange_id = 0;
+  state->import_positions = NULL;
+  state->num_exported = 0;
+  state->num_imported = 0;
+  state->model = calloc(state->num_vars + 1, sizeof(BOOLEAN));
+  state->num_failed_assumptions = 0;
+  state->failed_assumptions = malloc(sizeof(c2dLiteral) * (state->num_vars + 1));
+
+  state->probe_next_var = 1;
+  state->num_failed_literals = 0;
+  sat_set_probe_schedule(state, PROBE_INTERVAL, PROBE_BUDGET);
+
+  state->occurrences = NULL;
+  state->true_counts = NULL;
+  state->unsubsumed_counts = NULL;
+
+  state->eliminated = calloc(state->num_vars + 1, sizeof(BOOLEAN));
+  state->num_eliminated_vars = 0;
+  state->elim_stack = NULL;
+  state->elim_size = 0;
+
+  state->tmp_lit_list = malloc(sizeof(c2dLitCode) * (state->num_vars + 1));
+  state->seen = calloc(state->num_vars + 1, sizeof(BOOLEAN));
+  state->clear_list = malloc(sizeof(c2dLitCode) * (state->num_vars + 1));
+  state->lit_list = malloc(sizeof(c2dLitCode) * (state->num_vars + 1));
+
+  state->num_propagations = 0;
+  state->num_learned = 0;
+  state->learned_size_sum = 0;
+  state->learned_lbd_sum = 0;
+  state->max_trail_size = 0;
+  state->preprocess_time = 0;
+  state->probe_time = 0;
+  state->search_time = 0;
+
+  state->parse_time = cnf->parse_time + (sat_clock() - start);
+  return state;
+}
 
-  state->tmp_lit_list = malloc(sizeof(Lit*) * state->num_vars * 2);
-  state->seen = malloc(sizeof(BOOLEAN) * (state->num_vars+1));
-  state->lit_list = malloc(sizeof(Lit*) * state->num_vars * 2);
+//returns the number of seconds spent reading the cnf and building the sat state
+double sat_parse_time(const SatState* sat_state) {
+  return sat_state->parse_time;
+}
 
-  return state;
+//returns the statistics of sat state
+SatStats sat_stats(const SatState* sat_state) {
+  SatStats stats;
+  stats.decisions = sat_state->num_decisions;
+  stats.propagations = sat_state->num_propagations;
+  stats.conflicts = sat_state->num_conflicts;
+  stats.learned_clauses = sat_state->num_learned;
+  stats.kept_learned_clauses = sat_state->num_learned_clauses;
+  stats.deleted_clauses = sat_state->num_deleted_clauses;
+  stats.reductions = sat_state->num_reductions;
+  stats.restarts = sat_state->num_restarts;
+  stats.avg_learned_size = sat_state->num_learned > 0 ? (double)sat_state->learned_size_sum / sat_state->num_learned : 0;
+  stats.avg_learned_lbd = sat_state->num_learned > 0 ? (double)sat_state->learned_lbd_sum / sat_state->num_learned : 0;
+  stats.trail_depth = sat_state->trail_size;
+  stats.max_trail_depth = sat_state->max_trail_size;
+  stats.parse_time = sat_state->parse_time;
+  stats.preprocess_time = sat_state->preprocess_time;
+  stats.probe_time = sat_state->probe_time;
+  stats.search_time = sat_state->search_time;
+  return stats;
 }
 
 //frees the SatState
@@ -470,47 +941,72 @@ void sat_state_free(SatState* sat_state) {
   for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
     free(sat_state->variables[i]->clauses);
     free(sat_state->variables[i]);
-    free(sat_state->p_literals[i]->clauses);
     free(sat_state->p_literals[i]);
-    free(sat_state->n_literals[i]->clauses);  
     free(sat_state->n_literals[i]);
   }
+  for (c2dSize i = 0; i < 2 * (sat_state->num_vars + 1); i++) {
+    free(sat_state->watches[i].clauses);
+    free(sat_state->implications[i].lits);
+  }
   for (c2dSize i = 1; i <= sat_state->num_cnf_clauses; i++) {
-    free(sat_state->cnf_clauses[i]->literals);
+    release_literal_views(sat_state->cnf_clauses[i]);
   }
   for (c2dSize i = 0; i < sat_state->num_learned_clauses; i++) {
-    free(sat_state->learned_clauses[i]->literals);
+    release_literal_views(sat_state->learned_clauses[i]);
+  }
+  if (sat_state->asserted_clause != NULL && sat_state->asserted_clause->index == 0) {
+    release_literal_views(sat_state->asserted_clause);
   }
+  clause_arena_release(&(sat_state->cnf_arena));
+  clause_arena_release(&(sat_state->learned_arena));
   free(sat_state->variables);
   free(sat_state->p_literals);
   free(sat_state->n_literals);
+  free(sat_state->values);
+  free(sat_state->weights);
+  free(sat_state->levels);
+  free(sat_state->reasons);
+  free(sat_state->watches);
+  free(sat_state->implications);
+  free(sat_state->binary_conflict);
   free(sat_state->cnf_clauses);
   free(sat_state->learned_clauses);
   free(sat_state->decided_literals);
-  free(sat_state->implied_literals);
-  
+  free(sat_state->trail);
+
   free(sat_state->lit_list);
   free(sat_state->tmp_lit_list);
   free(sat_state->seen);
+  free(sat_state->clear_list);
+  free(sat_state->level_stamps);
+  free(sat_state->activity);
+  free(sat_state->phases);
+  free(sat_state->model);
+  free(sat_state->failed_assumptions);
+  free(sat_state->eliminated);
+  free(sat_state->elim_stack);
+  free(sat_state->import_positions);
+  sat_set_subsumption_tracking(sat_state, 0);
+  var_heap_release(&(sat_state->order));
   free(sat_state);
 }
 
 /******************************************************************************
  * Given a SatState, which should contain data related to the current setting
- * (i.e., decided literals, subsumed clauses, decision level, etc.), this function 
- * should perform unit resolution at the current decision level 
+ * (i.e., decided literals, subsumed clauses, decision level, etc.), this function
+ * should perform unit resolution at the current decision level
  *
  * It returns 1 if succeeds, 0 otherwise (after constructing an asserting
  * clause)
  *
  * There are three possible places where you should perform unit resolution:
  * (1) after deciding on a new literal (i.e., in sat_decide_literal())
- * (2) after adding an asserting clause (i.e., in sat_assert_clause(...)) 
+ * (2) after adding an asserting clause (i.e., in sat_assert_clause(...))
  * (3) neither the above, which would imply literals appearing in unit clauses
  *
  * (3) would typically happen only once and before the other two cases
  * It may be useful to distinguish between the above three cases
- * 
+ *
  * Note if the current decision level is L, then the literals implied by unit
  * resolution must have decision level L
  *
@@ -524,159 +1020,395 @@ void sat_state_free(SatState* sat_state) {
  * Yet, the first decided literal must have 2 as its decision level
  ******************************************************************************/
 
-// checks the clause:
-// returns -1: unconsistence right now
-// returns  0: unknown
-// returns  1: subsumed
-// returns  2: unit clause currently, return the lit
-c2dLiteral check_clause(Clause* clause, Lit** ret_lit) {
-  if (clause->decision_level > 0) return 1;
-  if (clause->num_false == clause->size) return -1;
-  if (clause->num_false + 1 == clause->size) {
-    for (c2dSize i = 0; i < clause->size; i++) {
-      if (clause->literals[i]->decision_level == 0 &&
-          clause->literals[i]->op_lit->decision_level == 0) {
-        *ret_lit = clause->literals[i];
-        break;
+// instantiates the literals implied by binary clauses, for the whole propagation queue
+// returns the conflicting clause if there is one, NULL otherwise
+static inline Clause* propagate_binaries(SatState* sat_state) {
+  c2dSize level = sat_state->cur_level;
+  BOOLEAN* values = sat_state->values;
+
+  while (sat_state->binary_head < sat_state->trail_size) {
+    c2dLitCode false_lit = code_op(sat_state->trail[sat_state->binary_head++]);
+    const ImplicationList* list = &(sat_state->implications[false_lit]);
+    for (c2dSize i = 0; i < list->size; i++) {
+      c2dLitCode lit = list->lits[i];
+      if (values[lit] > 0) continue;
+      if (values[lit] < 0) {
+        sat_state->binary_conflict->lits[0] = lit;
+        sat_state->binary_conflict->lits[1] = false_lit;
+        sat_state->trail_head = sat_state->binary_head = sat_state->trail_size;
+        return sat_state->binary_conflict;
       }
+      instantiate_literal(lit, level, binary_reason(false_lit), sat_state);
     }
-    return 2;
   }
-  return 0;
+  return NULL;
 }
 
-//applies unit resolution to the cnf of sat state
-//returns 1 if unit resolution succeeds, 0 if it finds a contradiction
-BOOLEAN sat_unit_resolution(SatState* sat_state) {
-  Lit* ret_lit;
-  Var* var;
-
-  c2dLiteral tmp_value;
-  Clause* conflict_clause = NULL;
+// visits the clauses watching the literals falsified by the propagation queue, after the
+// binary clauses have been propagated
+// returns the conflicting clause if there is one, NULL otherwise
+Clause* propagate(SatState* sat_state) {
+  c2dSize level = sat_state->cur_level;
+  BOOLEAN* values = sat_state->values;
+  c2dLitCode tmp;
+
+  while (sat_state->trail_head < sat_state->trail_size) {
+    Clause* conflict_clause = propagate_binaries(sat_state);
+    if (conflict_clause != NULL) return conflict_clause;
+
+    c2dLitCode false_lit = code_op(sat_state->trail[sat_state->trail_head++]);
+    SAT_STAT(++sat_state->num_propagations);
+    ClauseList* watch_list = &(sat_state->watches[false_lit]);
+    Clause** watches = watch_list->clauses;
+    c2dSize num_watches = watch_list->size;
+    c2dSize i = 0, j = 0;
+
+    while (i < num_watches) {
+      Clause* clause = watches[i++];
+      c2dLitCode* lits = clause->lits;
+
+      // Makes sure the falsified literal is lits[1]
+      if (lits[0] == false_lit) lits[0] = lits[1], lits[1] = false_lit;
+
+      // The other watched literal satisfies the clause
+      if (values[lits[0]] > 0) {
+        watches[j++] = clause;
+        continue;
+      }
 
-  c2dSize f = 0, r = 0;
-  Lit** tmp_lit_list = sat_state->tmp_lit_list;
+      // Looks for a new literal to watch
+      c2dSize k = 2;
+      while (k < clause->size && values[lits[k]] < 0) ++k;
+      if (k < clause->size) {
+        tmp = lits[1], lits[1] = lits[k], lits[k] = tmp;
+        ClauseList* w = &(sat_state->watches[lits[1]]);
+        clause_pointer_push(clause, &(w->clauses), &(w->size), &(w->cap));
+        continue;
+      }
 
-  // Push the new decided literal
-  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_AFTER_DECIDING_LITERAL) {
-    if (sat_state->num_decided_literals > 0) {
-      tmp_lit_list[++r] = sat_state->decided_literals[sat_state->num_decided_literals-1];
-    }
-    if (sat_state->num_implied_literals > 0) {
-      c2dSize i = sat_state->num_implied_literals - 1;
-      while (sat_state->implied_literals[i]->decision_level == sat_state->cur_level) {
-        tmp_lit_list[++r] = sat_state->implied_literals[i];
-        if (i == 0) break;
-        i--;
+      // The clause is unit or conflicting
+      watches[j++] = clause;
+      if (values[lits[0]] < 0) {
+        while (i < num_watches) watches[j++] = watches[i++];
+        watch_list->size = j;
+        sat_state->trail_head = sat_state->binary_head = sat_state->trail_size;
+        return clause;
       }
+      instantiate_literal(lits[0], level, clause, sat_state);
     }
+    watch_list->size = j;
   }
+  return NULL;
+}
 
-  // Check whether has unit clause
-  c2dSize start_clauses = 1;
-  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_AFTER_ASSERTING_CLAUSE) 
-    start_clauses = sat_state->num_cnf_clauses + sat_state->num_learned_clauses;
-  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_AFTER_DECIDING_LITERAL)
-    start_clauses = sat_state->num_cnf_clauses + sat_state->num_learned_clauses + 1;
-  for (c2dSize i = start_clauses; i <= sat_state->num_cnf_clauses + sat_state->num_learned_clauses; i++) {
-    Clause* clause = sat_index2clause(i, sat_state);
-    tmp_value = check_clause(clause, &ret_lit);
-    if (tmp_value == -1) {
-      conflict_clause = clause;
-      break;
-    }
-    if (tmp_value == 2) {
-      instantiate_literal(ret_lit, sat_state->cur_level, clause);
-      sat_state->implied_literals[sat_state->num_implied_literals++] = ret_lit;
-      tmp_lit_list[++r] = ret_lit;
-    }
+// checks the clauses which are not watched (size < 2) and the asserted clause
+// returns the conflicting clause if there is one, NULL otherwise
+Clause* check_unwatched_clause(Clause* clause, SatState* sat_state) {
+  if (clause->size == 0) return clause;
+  c2dLitCode lit = clause->lits[0];
+  if (clause->size == 1 || sat_state->values[clause->lits[1]] < 0) {
+    if (sat_state->values[lit] < 0) return clause;
+    if (sat_state->values[lit] == 0) instantiate_literal(lit, sat_state->cur_level, clause, sat_state);
   }
+  return NULL;
+}
 
-  if (conflict_clause == NULL) {
-    // BFS, expands the implied literals
-    while (f < r) {
-      var = sat_literal_var(tmp_lit_list[++f]);
-      for (c2dSize i = 0; i < var->num_clauses; i++) {
-        tmp_value = check_clause(var->clauses[i], &ret_lit);
-        if (tmp_value == -1) {
-          conflict_clause = var->clauses[i];
-          break;
-        }
-        if (tmp_value == 2) {
-          instantiate_literal(ret_lit, sat_state->cur_level, var->clauses[i]);
-          sat_state->implied_literals[sat_state->num_implied_literals++] = ret_lit;
-          tmp_lit_list[++r] = ret_lit;
-        }
+/******************************************************************************
+ * Conflict analysis
+ *
+ * The asserted clause is derived with the first UIP scheme: starting from the
+ * conflicting clause, the literals set at the current level are resolved away
+ * with their reasons, in the reverse order of the trail, until a single one is
+ * left (the first unique implication point). Literals set at level 1 are implied
+ * by the cnf and are dropped.
+ *
+ * The clause is then minimized by removing every literal whose reason only
+ * depends on other literals of the clause, which is checked recursively.
+ ******************************************************************************/
+
+static void bump_var_activity(c2dSize var, SatState* sat_state) {
+  double* activity = sat_state->activity;
+  if ((activity[var] += sat_state->var_inc) > 1e100) {
+    for (c2dSize i = 1; i <= sat_state->num_vars; i++) activity[i] *= 1e-100;
+    sat_state->var_inc *= 1e-100;
+  }
+  var_heap_increased(&(sat_state->order), var, activity);
+}
+
+// a bit per decision level, used to quickly rule out literals which cannot be redundant
+static inline unsigned int abstract_level(c2dSize var, const SatState* sat_state) {
+  return 1u << (sat_state->levels[var] & 31);
+}
+
+// returns 1 if the false literal lit is implied by the other literals of the clause being
+// derived (the ones marked as seen); the variables found to be implied are marked as well
+static BOOLEAN redundant_literal(c2dLitCode lit, unsigned int abstract_levels, SatState* sat_state,
+                                 c2dSize* num_clear) {
+  BOOLEAN* seen = sat_state->seen;
+  c2dLitCode* stack = sat_state->tmp_lit_list;
+  c2dLitCode* clear_list = sat_state->clear_list;
+  c2dSize top = *num_clear;
+  c2dSize stack_size = 0;
+  c2dLitCode binary[2];
+  c2dSize size;
+
+  stack[stack_size++] = lit;
+  while (stack_size > 0) {
+    c2dLitCode p = stack[--stack_size];
+    const c2dLitCode* lits = reason_lits(sat_state->reasons[code_var(p)], p, binary, &size);
+    for (c2dSize i = 1; i < size; i++) {
+      c2dLitCode q = lits[i];
+      c2dSize var = code_var(q);
+      if (seen[var] || sat_state->levels[var] <= 1) continue;
+
+      if (sat_state->reasons[var] != NULL && (abstract_level(var, sat_state) & abstract_levels)) {
+        seen[var] = 1;
+        stack[stack_size++] = code_op(q);
+        clear_list[(*num_clear)++] = q;
+      } else {
+        for (c2dSize j = top; j < *num_clear; j++) seen[code_var(clear_list[j])] = 0;
+        *num_clear = top;
+        return 0;
       }
     }
   }
+  return 1;
+}
 
-  if (conflict_clause == NULL) {
-    // No conflict
-    sat_state->asserted_clause = NULL;
-    return 1;
+// returns the asserted clause learned from the conflicting clause
+Clause* derive_asserted_clause(Clause* conflict_clause, SatState* sat_state) {
+  c2dSize level = sat_state->cur_level;
+  if (level <= 1) {
+    // the cnf is unsatisfiable
+    Clause* empty = new_clause(&(sat_state->learned_arena), 0, 0, NULL);
+    empty->assertion_level = 1;
+    return empty;
   }
 
-  // Has conflict, derives asserted clause  
-  //
-  // It follows the algorithm:
-  //
-  //    In implication graph, if the contradition happended at node n.
-  //    then 
-  //           { {n}   if n is root 
-  //    C(n) = {
-  //           { ePa(n) \union \union_{m \in Pa(n)} C(m)
-  //    where Pa(n) are the parents of node n which are set at the same level as n
-  //          ePa(n) are the parents of ndoe n set at earlier levels
-  // 
   BOOLEAN* seen = sat_state->seen;
-  for (c2dSize i = 1; i <= sat_state->num_vars; i++) seen[i] = 0;
-  Lit** lit_list = sat_state->lit_list;
-  c2dSize lit_list_sz = 0;
-
-  f = 0, r = 0;
-  for (c2dSize i = 0; i < conflict_clause->size; i++) {
-    if (!seen[conflict_clause->literals[i]->var->index]) {
-      tmp_lit_list[++r] = conflict_clause->literals[i]->op_lit;
-      seen[conflict_clause->literals[i]->var->index] = 1;
+  c2dLitCode* lit_list = sat_state->lit_list;
+  c2dSize lit_list_sz = 1;  // lit_list[0] is the asserted literal
+  c2dSize num_current = 0;  // number of seen literals set at the current level
+  c2dSize index = sat_state->trail_size;
+  c2dLitCode uip = 0;
+  Clause* clause = conflict_clause;
+  c2dLitCode binary[2];
+  c2dSize size;
+
+  do {
+    const c2dLitCode* lits = reason_lits(clause, uip, binary, &size);
+
+    // Learned clauses taking part in the conflict become more valuable
+    if (!is_binary_reason(clause) && clause->index > sat_state->num_cnf_clauses) {
+      bump_clause_activity(clause, sat_state);
+      if (clause->lbd > 2) {
+        unsigned int lbd = clause_lbd(clause->lits, clause->size, sat_state);
+        if (lbd < clause->lbd) clause->lbd = lbd;
+      }
+    }
+    for (c2dSize i = (clause == conflict_clause ? 0 : 1); i < size; i++) {
+      c2dLitCode q = lits[i];
+      c2dSize var = code_var(q);
+      if (seen[var] || sat_state->levels[var] <= 1) continue;
+      seen[var] = 1;
+      bump_var_activity(var, sat_state);
+      if (sat_state->levels[var] == level) ++num_current;
+      else lit_list[lit_list_sz++] = q;
+    }
+
+    // the next literal to resolve on is the last seen one on the trail
+    while (!seen[code_var(sat_state->trail[--index])]);
+    uip = sat_state->trail[index];
+    clause = sat_state->reasons[code_var(uip)];
+    seen[code_var(uip)] = 0;
+  } while (--num_current > 0);
+  lit_list[0] = code_op(uip);
+
+  // Minimization
+  c2dLitCode* clear_list = sat_state->clear_list;
+  c2dSize num_clear = 0;
+  unsigned int abstract_levels = 0;
+  for (c2dSize i = 1; i < lit_list_sz; i++) {
+    abstract_levels |= abstract_level(code_var(lit_list[i]), sat_state);
+    clear_list[num_clear++] = lit_list[i];
+  }
+  c2dSize j = 1;
+  for (c2dSize i = 1; i < lit_list_sz; i++) {
+    c2dSize var = code_var(lit_list[i]);
+    if (sat_state->reasons[var] == NULL ||
+        !redundant_literal(code_op(lit_list[i]), abstract_levels, sat_state, &num_clear)) {
+      lit_list[j++] = lit_list[i];
     }
   }
+  lit_list_sz = j;
+  for (c2dSize i = 0; i < num_clear; i++) seen[code_var(clear_list[i])] = 0;
 
+  // The assertion level is the highest level among the other literals
   c2dSize assertion_level = 1;
-  c2dSize dl;
-  while (f < r) {
-    Lit* lit = tmp_lit_list[++f];
-    if (lit->decision_level < sat_state->cur_level ||
-        lit->decision_clause == NULL) {
-      lit_list[lit_list_sz++] = lit->op_lit;
-      dl = lit->decision_level;
-      if (dl < sat_state->cur_level && dl > assertion_level) {
-        assertion_level = dl;
-      }
-    } else {
-      for (c2dSize i = 0; i < lit->decision_clause->size; i++) {
-        if (!seen[lit->decision_clause->literals[i]->var->index]) {
-          tmp_lit_list[++r] = lit->decision_clause->literals[i]->op_lit;
-          seen[lit->decision_clause->literals[i]->var->index] = 1;
-        }
-      }
+  for (c2dSize i = 1; i < lit_list_sz; i++) {
+    c2dSize dl = sat_state->levels[code_var(lit_list[i])];
+    if (dl > assertion_level) {
+      assertion_level = dl;
+      c2dLitCode tmp = lit_list[1];
+      lit_list[1] = lit_list[i];
+      lit_list[i] = tmp;
     }
   }
-  sat_state->asserted_clause = new_clause(0, lit_list_sz, lit_list);
-  sat_state->asserted_clause->assertion_level = assertion_level;
 
+  Clause* asserted = new_clause(&(sat_state->learned_arena), 0, lit_list_sz, lit_list);
+  asserted->assertion_level = assertion_level;
+  asserted->lbd = clause_lbd(lit_list, lit_list_sz, sat_state);
+  clause_literal_views(asserted, sat_state);
+  return asserted;
+}
+
+//applies unit resolution to the cnf of sat state
+//returns 1 if unit resolution succeeds, 0 if it finds a contradiction
+BOOLEAN sat_unit_resolution(SatState* sat_state) {
+  SAT_TRACE_BEGIN(TRACE_UNIT_RESOLUTION);
+  Clause* conflict_clause = NULL;
+  c2dSize num_clauses = sat_state->num_cnf_clauses + sat_state->num_learned_clauses;
+
+  // A clause derived before but never asserted is not needed anymore
+  if (sat_state->asserted_clause != NULL && sat_state->asserted_clause->index == 0) {
+    release_literal_views(sat_state->asserted_clause);
+    clause_arena_free(&(sat_state->learned_arena), sat_state->asserted_clause);
+  }
+  sat_state->asserted_clause = NULL;
+
+  // The decided literal has been pushed to the propagation queue already.
+  // Unit clauses are never watched, so they are checked here for the first time,
+  // and the asserted clause (the last learned one) is checked after asserting it
+  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_FIRST_TIME) {
+    for (c2dSize i = 1; i <= num_clauses && conflict_clause == NULL; i++) {
+      Clause* clause = index2clause(i, sat_state);
+      if (clause->size < 2) conflict_clause = check_unwatched_clause(clause, sat_state);
+    }
+  } else if (sat_state->unit_resolution_s == UNIT_RESOLUTION_AFTER_ASSERTING_CLAUSE) {
+    conflict_clause = check_unwatched_clause(index2clause(num_clauses, sat_state), sat_state);
+  }
+
+  if (conflict_clause == NULL) conflict_clause = propagate(sat_state);
+
+  if (conflict_clause == NULL) {
+    // No conflict
+    SAT_TRACE_END(TRACE_UNIT_RESOLUTION);
+    return 1;
+  }
+
+  ++sat_state->num_conflicts;
+  sat_state->clause_inc /= CLAUSE_DECAY;
+  sat_state->var_inc /= VAR_DECAY;
+
+  // Reclaims the memory of the learned clauses which have been freed
+  ClauseArena* arena = &(sat_state->learned_arena);
+  if (arena->wasted >= LEARNED_ARENA_BLOCK && arena->wasted > arena->live) {
+    collect_learned_clauses(sat_state, &conflict_clause);
+  }
+
+  // Has conflict, derives asserted clause
+  SAT_TRACE_BEGIN(TRACE_ANALYSIS);
+  sat_state->asserted_clause = derive_asserted_clause(conflict_clause, sat_state);
+  SAT_TRACE_END(TRACE_ANALYSIS);
+  restart_on_conflict(sat_state->asserted_clause->lbd, sat_state);
+  SAT_STAT(++sat_state->num_learned;
+           sat_state->learned_size_sum += sat_state->asserted_clause->size;
+           sat_state->learned_lbd_sum += sat_state->asserted_clause->lbd);
+  if (sat_state->exchange != NULL) export_clause(sat_state->asserted_clause, sat_state);
+  SAT_TRACE_END(TRACE_UNIT_RESOLUTION);
   return 0;
 }
 
 //undoes sat_unit_resolution(), leading to un-instantiating variables that have been instantiated
 //after sat_unit_resolution()
 void sat_undo_unit_resolution(SatState* sat_state) {
-  c2dSize sz = sat_state->num_implied_literals;
-  while (sz > 0 && sat_state->implied_literals[sz - 1]->decision_level >= sat_state->cur_level) {
-    undo_instantiate_literal(sat_state->implied_literals[sz - 1]);
+  SAT_TRACE_BEGIN(TRACE_UNDO);
+  c2dSize sz = sat_state->trail_size;
+  while (sz > 0 && sat_state->levels[code_var(sat_state->trail[sz - 1])] >= sat_state->cur_level) {
+    undo_instantiate_literal(sat_state->trail[sz - 1], sat_state);
     --sz;
   }
-  sat_state->num_implied_literals = sz;
+  sat_state->trail_size = sz;
+  sat_state->trail_head = sz;
+  sat_state->binary_head = sz;
+  SAT_TRACE_END(TRACE_UNDO);
+}
+
+// asserts clause at the first decision level, and then the clauses learned from the conflicts
+// it leads to, until none is left
+// returns 0 if the empty clause is learned
+BOOLEAN assert_at_first_level(Clause* clause, SatState* sat_state) {
+  while (clause != NULL) {
+    if (clause->size == 0) {
+      sat_state->inconsistent = 1;
+      return 0;
+    }
+    clause = sat_assert_clause(clause, sat_state);
+  }
+  return 1;
+}
+
+// learns a clause implied by the cnf (found by probing, or by another search) at the first
+// decision level, where the sat state must be
+// returns 0 if the cnf turns out to be unsatisfiable
+BOOLEAN learn_implied_clause(const c2dLitCode* lits, c2dSize size, SatState* sat_state) {
+  Clause* clause = new_clause(&(sat_state->learned_arena), 0, size, lits);
+  clause->assertion_level = 1;
+  clause->lbd = (unsigned int)size;
+  return assert_at_first_level(clause, sat_state);
+}
+
+/******************************************************************************
+ * Incremental clauses
+ *
+ * Clauses can be added to the cnf of a sat state which has been used already.
+ * The sat state goes back to the first decision level, where the new clause is
+ * checked against the assignment and propagated, so that the invariants of the
+ * watches hold as if the clause had been there from the start.
+ ******************************************************************************/
+
+//adds a clause to the cnf of sat state, given by the indices of its literals
+//the clause becomes the last cnf clause, the learned clauses are renumbered after it, and the
+//sat state backtracks to the first decision level
+//returns the new clause, or NULL if one of the literals does not belong to the cnf (or its
+//variable has been eliminated by sat_preprocess())
+Clause* sat_add_clause(const c2dLiteral* literals, c2dSize size, SatState* sat_state) {
+  for (c2dSize i = 0; i < size; i++) {
+    c2dSize var = (c2dSize)labs(literals[i]);
+    if (var == 0 || var > sat_state->num_vars || sat_state->eliminated[var]) return NULL;
+  }
+  sat_backtrack_to_level(1, sat_state);
+
+  c2dSize index = ++sat_state->num_cnf_clauses;
+  if (index == sat_state->cnf_cap) {
+    sat_state->cnf_cap *= 2;
+    sat_state->cnf_clauses = realloc(sat_state->cnf_clauses, sizeof(Clause*) * sat_state->cnf_cap);
+  }
+  Clause* clause = new_clause(&(sat_state->cnf_arena), index, size, NULL);
+  for (c2dSize i = 0; i < size; i++) clause->lits[i] = lit_code(literals[i]);
+  sat_state->cnf_clauses[index] = clause;
+  for (c2dSize i = 0; i < sat_state->num_learned_clauses; i++) {
+    sat_state->learned_clauses[i]->index = index + i + 1;
+  }
+
+  push_clause_to_vars(clause, sat_state);
+  for (c2dSize i = 0; i < size; i++) {
+    Var* var = sat_state->variables[code_var(clause->lits[i])];
+    var->num_cnf_clauses = var->num_clauses;
+  }
+  subsumption_clause_added(clause, sat_state);
+
+  // Before the first unit resolution, the new clause is checked together with the others
+  order_watches(clause, sat_state);
+  watch_clause(clause, sat_state);
+  if (sat_state->unit_resolution_s != UNIT_RESOLUTION_FIRST_TIME && !sat_state->inconsistent) {
+    if (check_unwatched_clause(clause, sat_state) != NULL || propagate(sat_state) != NULL) {
+      sat_state->inconsistent = 1;
+    }
+  }
+
+  clause_literal_views(clause, sat_state);
+  return clause;
 }
 
 //returns 1 if the decision level of the sat state equals to the assertion level of clause,
@@ -692,11 +1424,6 @@ BOOLEAN sat_at_assertion_level(const Clause* clause, const SatState* sat_state)
  * The functions below are already implemented for you and MUST STAY AS IS
  ******************************************************************************/
 
-//returns the weight of a literal (which is 1 for our purposes)
-c2dWmc sat_literal_weight(const Lit* lit) {
-  return 1;
-}
-
 //returns 1 if a variable is marked, 0 otherwise
 BOOLEAN sat_marked_var(const Var* var) {
   return var->mark;
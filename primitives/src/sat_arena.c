@@ -0,0 +1,71 @@
+#include <stddef.h>
+
+#include "sat_api.h"
+
+/******************************************************************************
+ * Clause arena
+ *
+ * Clauses are allocated together with their literal codes in large blocks, so
+ * that a clause and its literals are adjacent in memory and clauses allocated
+ * one after another stay close to each other.
+ *
+ * Blocks are never moved, hence a clause pointer stays valid until the arena is
+ * compacted (see collect_learned_clauses() in sat_api.c) or released.
+ ******************************************************************************/
+
+#define ARENA_ALIGN(x) (((x) + 7) & ~(c2dSize)7)
+
+// number of bytes taken by a clause with the given number of literals
+c2dSize clause_arena_bytes(c2dSize clause_size) {
+  return ARENA_ALIGN(offsetof(Clause, lits) + sizeof(c2dLitCode) * clause_size);
+}
+
+void clause_arena_init(ClauseArena* arena, c2dSize block_size) {
+  arena->num_blocks = 0;
+  arena->blocks_cap = 4;
+  arena->blocks = malloc(sizeof(char*) * arena->blocks_cap);
+  arena->block_size = ARENA_ALIGN(block_size);
+  arena->used = arena->block_size;  // forces a block to be allocated on first use
+  arena->live = 0;
+  arena->wasted = 0;
+}
+
+// allocates a clause with room for clause_size literals right after the struct
+Clause* clause_arena_alloc(ClauseArena* arena, c2dSize clause_size) {
+  c2dSize bytes = clause_arena_bytes(clause_size);
+  if (arena->used + bytes > arena->block_size) {
+    if (arena->num_blocks > 0) arena->block_size *= 2;
+    // an arena sized for no clause (e.g. a cnf emptied by sat_preprocess()) has no block yet
+    while (arena->block_size < bytes) arena->block_size = arena->block_size > 0 ? 2 * arena->block_size : bytes;
+    if (arena->num_blocks == arena->blocks_cap) {
+      arena->blocks_cap *= 2;
+      arena->blocks = realloc(arena->blocks, sizeof(char*) * arena->blocks_cap);
+    }
+    arena->blocks[arena->num_blocks++] = malloc(arena->block_size);
+    arena->used = 0;
+  }
+  Clause* clause = (Clause*)(arena->blocks[arena->num_blocks - 1] + arena->used);
+  clause->literals = NULL;
+  clause->size = (unsigned int)clause_size;
+  arena->used += bytes;
+  arena->live += bytes;
+  return clause;
+}
+
+// the memory of the clause is reclaimed the next time the arena is compacted
+void clause_arena_free(ClauseArena* arena, Clause* clause) {
+  c2dSize bytes = clause_arena_bytes(clause->size);
+  arena->live -= bytes;
+  arena->wasted += bytes;
+}
+
+void clause_arena_release(ClauseArena* arena) {
+  for (c2dSize i = 0; i < arena->num_blocks; i++) free(arena->blocks[i]);
+  free(arena->blocks);
+  arena->blocks = NULL;
+  arena->num_blocks = 0;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,319 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Component cache
+ *
+ * The key of a component is its sorted variable indices, a 0, and its sorted
+ * cnf clause indices, each index written as its difference with the previous one
+ * (which is at least 1, so 0 only appears as the separator) in 7-bit groups. A
+ * component of a few hundred variables and clauses then takes a few hundred
+ * bytes, compared byte for byte on a hash match.
+ *
+ * The entries live in one array, linked in their hash bucket and in the order of
+ * their last use. Storing a count (or node) evicts the least recently used
+ * entries until the new one fits in the budget.
+ *
+ * The journal lists the entry of every store, and an entry remembers the position
+ * of its last store, so forgetting the stores since a mark pops the journal and
+ * removes the entries which were not evicted or stored again in the meantime.
+ ******************************************************************************/
+
+#define CACHE_NONE ((c2dSize)-1)
+
+//returns an empty component cache taking up to budget bytes (entries and keys), which holds
+//counts (CACHE_COUNTS) or circuit nodes (CACHE_NODES)
+ComponentCache* component_cache_new(c2dSize budget, CacheContent content) {
+  ComponentCache* cache = malloc(sizeof(ComponentCache));
+  cache->content = content;
+  cache->budget = budget;
+  cache->bytes = 0;
+  cache->num_entries = 0;
+  cache->entries_cap = 64;
+  cache->entries = malloc(sizeof(CacheEntry) * cache->entries_cap);
+  cache->free_entries = CACHE_NONE;
+  cache->num_used = 0;
+  cache->num_buckets = 64;
+  cache->buckets = malloc(sizeof(c2dSize) * cache->num_buckets);
+  for (c2dSize i = 0; i < cache->num_buckets; i++) cache->buckets[i] = CACHE_NONE;
+  cache->lru_first = cache->lru_last = CACHE_NONE;
+  cache->key_cap = 256;
+  cache->key = malloc(cache->key_cap);
+  cache->sort_cap = 256;
+  cache->sort_buf = malloc(sizeof(c2dSize) * cache->sort_cap);
+  cache->journal_size = 0;
+  cache->journal_cap = 64;
+  cache->journal = malloc(sizeof(c2dSize) * cache->journal_cap);
+  cache->num_hits = 0;
+  cache->num_misses = 0;
+  cache->num_stores = 0;
+  cache->num_evictions = 0;
+  cache->num_forgotten = 0;
+  return cache;
+}
+
+//frees a component cache
+void component_cache_free(ComponentCache* cache) {
+  for (c2dSize i = 0; i < cache->num_used; i++) free(cache->entries[i].key);
+  free(cache->entries);
+  free(cache->buckets);
+  free(cache->key);
+  free(cache->sort_buf);
+  free(cache->journal);
+  free(cache);
+}
+
+static int compare_indices(const void* a, const void* b) {
+  c2dSize x = *(const c2dSize*)a, y = *(const c2dSize*)b;
+  return x < y ? -1 : x > y;
+}
+
+static void key_reserve(ComponentCache* cache, c2dSize len) {
+  if (len <= cache->key_cap) return;
+  while (len > cache->key_cap) cache->key_cap *= 2;
+  cache->key = realloc(cache->key, cache->key_cap);
+}
+
+// appends the sorted indices to the key, as differences in 7-bit groups
+static c2dSize encode_indices(ComponentCache* cache, c2dSize len, const c2dSize* indices, c2dSize size) {
+  if (size > cache->sort_cap) {
+    while (size > cache->sort_cap) cache->sort_cap *= 2;
+    cache->sort_buf = realloc(cache->sort_buf, sizeof(c2dSize) * cache->sort_cap);
+  }
+  memcpy(cache->sort_buf, indices, sizeof(c2dSize) * size);
+  qsort(cache->sort_buf, size, sizeof(c2dSize), compare_indices);
+
+  // an index takes at most 10 bytes
+  key_reserve(cache, len + 10 * size + 1);
+  unsigned char* key = cache->key;
+  c2dSize previous = 0;
+  for (c2dSize i = 0; i < size; i++) {
+    c2dSize delta = cache->sort_buf[i] - previous;
+    previous = cache->sort_buf[i];
+    while (delta >= 0x80) {
+      key[len++] = (unsigned char)(delta | 0x80);
+      delta >>= 7;
+    }
+    key[len++] = (unsigned char)delta;
+  }
+  return len;
+}
+
+// writes the key of the component to cache->key, returns its length
+static c2dSize encode_key(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                          const c2dSize* clauses, c2dSize num_clauses) {
+  c2dSize len = encode_indices(cache, 0, vars, num_vars);
+  cache->key[len++] = 0;
+  return encode_indices(cache, len, clauses, num_clauses);
+}
+
+// FNV-1a
+static uint64_t hash_key(const unsigned char* key, c2dSize len) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (c2dSize i = 0; i < len; i++) {
+    hash ^= key[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static c2dSize find_entry(const ComponentCache* cache, uint64_t hash, c2dSize len) {
+  c2dSize e = cache->buckets[hash & (cache->num_buckets - 1)];
+  for (; e != CACHE_NONE; e = cache->entries[e].bucket_next) {
+    const CacheEntry* entry = &(cache->entries[e]);
+    if (entry->hash == hash && entry->key_len == len && memcmp(entry->key, cache->key, len) == 0) return e;
+  }
+  return CACHE_NONE;
+}
+
+static void lru_unlink(ComponentCache* cache, c2dSize e) {
+  CacheEntry* entry = &(cache->entries[e]);
+  if (entry->lru_prev != CACHE_NONE) cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+  else cache->lru_first = entry->lru_next;
+  if (entry->lru_next != CACHE_NONE) cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+  else cache->lru_last = entry->lru_prev;
+}
+
+static void lru_push_first(ComponentCache* cache, c2dSize e) {
+  CacheEntry* entry = &(cache->entries[e]);
+  entry->lru_prev = CACHE_NONE;
+  entry->lru_next = cache->lru_first;
+  if (cache->lru_first != CACHE_NONE) cache->entries[cache->lru_first].lru_prev = e;
+  else cache->lru_last = e;
+  cache->lru_first = e;
+}
+
+static c2dSize entry_bytes(c2dSize key_len) {
+  return sizeof(CacheEntry) + key_len;
+}
+
+static void remove_entry(ComponentCache* cache, c2dSize e) {
+  CacheEntry* entry = &(cache->entries[e]);
+  c2dSize* link = &(cache->buckets[entry->hash & (cache->num_buckets - 1)]);
+  while (*link != e) link = &(cache->entries[*link].bucket_next);
+  *link = entry->bucket_next;
+  lru_unlink(cache, e);
+
+  cache->bytes -= entry_bytes(entry->key_len);
+  free(entry->key);
+  entry->key = NULL;
+  entry->bucket_next = cache->free_entries;
+  cache->free_entries = e;
+  --cache->num_entries;
+}
+
+// doubles the buckets, once there are more entries than buckets
+static void grow_buckets(ComponentCache* cache) {
+  free(cache->buckets);
+  cache->num_buckets *= 2;
+  cache->buckets = malloc(sizeof(c2dSize) * cache->num_buckets);
+  for (c2dSize i = 0; i < cache->num_buckets; i++) cache->buckets[i] = CACHE_NONE;
+  for (c2dSize e = cache->lru_first; e != CACHE_NONE; e = cache->entries[e].lru_next) {
+    CacheEntry* entry = &(cache->entries[e]);
+    c2dSize* bucket = &(cache->buckets[entry->hash & (cache->num_buckets - 1)]);
+    entry->bucket_next = *bucket;
+    *bucket = e;
+  }
+}
+
+static void journal_store(ComponentCache* cache, c2dSize e) {
+  if (cache->journal_size == cache->journal_cap) {
+    cache->journal_cap *= 2;
+    cache->journal = realloc(cache->journal, sizeof(c2dSize) * cache->journal_cap);
+  }
+  cache->entries[e].stamp = cache->journal_size;
+  cache->journal[cache->journal_size++] = e;
+}
+
+static c2dSize new_entry(ComponentCache* cache) {
+  if (cache->free_entries != CACHE_NONE) {
+    c2dSize e = cache->free_entries;
+    cache->free_entries = cache->entries[e].bucket_next;
+    return e;
+  }
+  if (cache->num_used == cache->entries_cap) {
+    cache->entries_cap *= 2;
+    cache->entries = realloc(cache->entries, sizeof(CacheEntry) * cache->entries_cap);
+  }
+  return cache->num_used++;
+}
+
+// returns the entry of the component, CACHE_NONE on a miss
+static c2dSize lookup_entry(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                            const c2dSize* clauses, c2dSize num_clauses) {
+  c2dSize len = encode_key(cache, vars, num_vars, clauses, num_clauses);
+  c2dSize e = find_entry(cache, hash_key(cache->key, len), len);
+  if (e == CACHE_NONE) {
+    ++cache->num_misses;
+    return CACHE_NONE;
+  }
+  ++cache->num_hits;
+  lru_unlink(cache, e);
+  lru_push_first(cache, e);
+  return e;
+}
+
+// returns the entry of the component, made if there is none, or CACHE_NONE if the entry alone
+// exceeds the budget; the caller sets its value
+static c2dSize store_entry(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                           const c2dSize* clauses, c2dSize num_clauses) {
+  c2dSize len = encode_key(cache, vars, num_vars, clauses, num_clauses);
+  uint64_t hash = hash_key(cache->key, len);
+  c2dSize e = find_entry(cache, hash, len);
+  if (e != CACHE_NONE) {
+    lru_unlink(cache, e);
+    lru_push_first(cache, e);
+    journal_store(cache, e);
+    return e;
+  }
+  c2dSize bytes = entry_bytes(len);
+  if (bytes > cache->budget) return CACHE_NONE;
+  while (cache->bytes + bytes > cache->budget) {
+    remove_entry(cache, cache->lru_last);
+    ++cache->num_evictions;
+  }
+
+  if (cache->num_entries == cache->num_buckets) grow_buckets(cache);
+  e = new_entry(cache);
+  CacheEntry* entry = &(cache->entries[e]);
+  entry->hash = hash;
+  entry->key_len = len;
+  entry->key = malloc(len);
+  memcpy(entry->key, cache->key, len);
+  c2dSize* bucket = &(cache->buckets[hash & (cache->num_buckets - 1)]);
+  entry->bucket_next = *bucket;
+  *bucket = e;
+  lru_push_first(cache, e);
+  journal_store(cache, e);
+  cache->bytes += bytes;
+  ++cache->num_entries;
+  ++cache->num_stores;
+  return e;
+}
+
+//looks up the count of the component given by its variable and cnf clause indices (in any
+//order), as found by sat_components() or sat_split_component()
+//returns 1 and sets *count on a hit, 0 on a miss
+BOOLEAN component_cache_lookup(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                               const c2dSize* clauses, c2dSize num_clauses, c2dWmc* count) {
+  assert(cache->content == CACHE_COUNTS);
+  c2dSize e = lookup_entry(cache, vars, num_vars, clauses, num_clauses);
+  if (e == CACHE_NONE) return 0;
+  *count = cache->entries[e].value.count;
+  return 1;
+}
+
+//stores the count of the component, evicting the least recently used entries to stay within
+//the budget; a component whose entry alone exceeds the budget is not stored
+void component_cache_store(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                           const c2dSize* clauses, c2dSize num_clauses, c2dWmc count) {
+  assert(cache->content == CACHE_COUNTS);
+  c2dSize e = store_entry(cache, vars, num_vars, clauses, num_clauses);
+  if (e != CACHE_NONE) cache->entries[e].value.count = count;
+}
+
+//looks up the node of the component, as component_cache_lookup() does its count
+//returns 1 and sets *node on a hit, 0 on a miss
+BOOLEAN component_cache_lookup_node(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                                    const c2dSize* clauses, c2dSize num_clauses, c2dSize* node) {
+  assert(cache->content == CACHE_NODES);
+  c2dSize e = lookup_entry(cache, vars, num_vars, clauses, num_clauses);
+  if (e == CACHE_NONE) return 0;
+  *node = cache->entries[e].value.node;
+  return 1;
+}
+
+//stores the node of the component, as component_cache_store() does its count
+void component_cache_store_node(ComponentCache* cache, const c2dSize* vars, c2dSize num_vars,
+                                const c2dSize* clauses, c2dSize num_clauses, c2dSize node) {
+  assert(cache->content == CACHE_NODES);
+  c2dSize e = store_entry(cache, vars, num_vars, clauses, num_clauses);
+  if (e != CACHE_NONE) cache->entries[e].value.node = node;
+}
+
+//returns a mark of the stores made so far, for component_cache_forget()
+c2dSize component_cache_mark(const ComponentCache* cache) {
+  return cache->journal_size;
+}
+
+//removes the entries stored or updated since mark was returned by component_cache_mark()
+void component_cache_forget(ComponentCache* cache, c2dSize mark) {
+  while (cache->journal_size > mark) {
+    c2dSize e = cache->journal[--cache->journal_size];
+    if (cache->entries[e].key == NULL || cache->entries[e].stamp != cache->journal_size) continue;
+    remove_entry(cache, e);
+    ++cache->num_forgotten;
+  }
+}
+
+//prints the hits, misses, stores, evictions and size of the cache
+void component_cache_print_stats(const ComponentCache* cache, FILE* file) {
+  c2dSize lookups = cache->num_hits + cache->num_misses;
+  fprintf(file, "c cache: %lu hits, %lu misses (%.1f%% hits), %lu stores, %lu evictions, %lu forgotten\n",
+          cache->num_hits, cache->num_misses, lookups > 0 ? 100.0 * cache->num_hits / lookups : 0.0,
+          cache->num_stores, cache->num_evictions, cache->num_forgotten);
+  fprintf(file, "c cache: %lu entries, %lu of %lu bytes\n", cache->num_entries, cache->bytes, cache->budget);
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,386 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Decision-DNNF compiler
+ *
+ * The node table is an arena: nodes are appended to one array and their
+ * children to another, both growing by doubling, and a node is referred to by
+ * its index. Since children are made before their parents, the indices are a
+ * topological order, which is the order nnf_write() needs.
+ *
+ * The compilation of a component is a decision node on one of its variables.
+ * Each branch decides the variable, splits the component under the new
+ * assignment, and conjoins the literals of the component set by unit resolution
+ * with the compilations of the components it falls into. The cache keeps the
+ * node of each component compiled.
+ *
+ * A conflict stops the compilation of every frame above the assertion level of
+ * the learned clause. Components compiled in the frame of that level may rely on
+ * the conflicting assignment, so their cache entries are forgotten before the
+ * clause is asserted and the frame is split again.
+ ******************************************************************************/
+
+#define NNF_NONE ((c2dSize)-1)
+#define COMPILE_CONFLICT ((c2dSize)-2)  // the compilation backtracks to the assertion level
+#define NO_COMPONENT ((c2dSize)-1)      // the whole cnf
+
+static uint64_t hash_node(NnfKind kind, c2dLiteral literal, const c2dSize* children, c2dSize num_children) {
+  uint64_t hash = 14695981039346656037ULL;
+  hash = (hash ^ (uint64_t)kind) * 1099511628211ULL;
+  hash = (hash ^ (uint64_t)literal) * 1099511628211ULL;
+  for (c2dSize i = 0; i < num_children; i++) hash = (hash ^ (uint64_t)children[i]) * 1099511628211ULL;
+  return hash ^ (hash >> 29);
+}
+
+// doubles the buckets, once there are more nodes than buckets
+static void grow_buckets(NnfCircuit* circuit) {
+  free(circuit->buckets);
+  circuit->num_buckets *= 2;
+  circuit->buckets = malloc(sizeof(c2dSize) * circuit->num_buckets);
+  for (c2dSize i = 0; i < circuit->num_buckets; i++) circuit->buckets[i] = NNF_NONE;
+  for (c2dSize n = 0; n < circuit->num_nodes; n++) {
+    c2dSize* bucket = &(circuit->buckets[circuit->nodes[n].hash & (circuit->num_buckets - 1)]);
+    circuit->nodes[n].bucket_next = *bucket;
+    *bucket = n;
+  }
+}
+
+// returns the node with the given kind, literal and children, which is made if the unique
+// table does not have it yet
+static c2dSize unique_node(NnfCircuit* circuit, NnfKind kind, c2dLiteral literal,
+                           const c2dSize* children, c2dSize num_children) {
+  uint64_t hash = hash_node(kind, literal, children, num_children);
+  c2dSize n = circuit->buckets[hash & (circuit->num_buckets - 1)];
+  for (; n != NNF_NONE; n = circuit->nodes[n].bucket_next) {
+    const NnfNode* node = &(circuit->nodes[n]);
+    if (node->hash == hash && node->kind == kind && node->literal == literal && node->num_children == num_children &&
+        (num_children == 0 || memcmp(circuit->children + node->children, children, sizeof(c2dSize) * num_children) == 0)) {
+      ++circuit->num_shared;
+      return n;
+    }
+  }
+
+  if (circuit->num_nodes == circuit->nodes_cap) {
+    circuit->nodes_cap *= 2;
+    circuit->nodes = realloc(circuit->nodes, sizeof(NnfNode) * circuit->nodes_cap);
+  }
+  if (circuit->num_children + num_children > circuit->children_cap) {
+    while (circuit->num_children + num_children > circuit->children_cap) circuit->children_cap *= 2;
+    circuit->children = realloc(circuit->children, sizeof(c2dSize) * circuit->children_cap);
+  }
+  n = circuit->num_nodes++;
+  NnfNode* node = &(circuit->nodes[n]);
+  node->kind = kind;
+  node->literal = literal;
+  node->num_children = num_children;
+  node->children = circuit->num_children;
+  node->hash = hash;
+  if (num_children > 0) memcpy(circuit->children + circuit->num_children, children, sizeof(c2dSize) * num_children);
+  circuit->num_children += num_children;
+
+  if (circuit->num_nodes > circuit->num_buckets) {
+    grow_buckets(circuit);
+  } else {
+    c2dSize* bucket = &(circuit->buckets[hash & (circuit->num_buckets - 1)]);
+    node->bucket_next = *bucket;
+    *bucket = n;
+  }
+  return n;
+}
+
+//returns a circuit over num_vars variables with the nodes false and true only
+NnfCircuit* nnf_circuit_new(c2dSize num_vars) {
+  NnfCircuit* circuit = malloc(sizeof(NnfCircuit));
+  circuit->num_vars = num_vars;
+  circuit->num_nodes = 0;
+  circuit->nodes_cap = 1024;
+  circuit->nodes = malloc(sizeof(NnfNode) * circuit->nodes_cap);
+  circuit->num_children = 0;
+  circuit->children_cap = 4096;
+  circuit->children = malloc(sizeof(c2dSize) * circuit->children_cap);
+  circuit->num_buckets = 1024;
+  circuit->buckets = malloc(sizeof(c2dSize) * circuit->num_buckets);
+  for (c2dSize i = 0; i < circuit->num_buckets; i++) circuit->buckets[i] = NNF_NONE;
+  circuit->num_shared = 0;
+  circuit->compile_time = 0;
+
+  unique_node(circuit, NNF_OR, 0, NULL, 0);
+  unique_node(circuit, NNF_AND, 0, NULL, 0);
+  circuit->root = NNF_TRUE;
+  return circuit;
+}
+
+//frees a circuit
+void nnf_circuit_free(NnfCircuit* circuit) {
+  free(circuit->nodes);
+  free(circuit->children);
+  free(circuit->buckets);
+  free(circuit);
+}
+
+//returns the node of a literal
+c2dSize nnf_literal(NnfCircuit* circuit, c2dLiteral literal) {
+  return unique_node(circuit, NNF_LITERAL, literal, NULL, 0);
+}
+
+static int compare_nodes(const void* a, const void* b) {
+  c2dSize x = *(const c2dSize*)a, y = *(const c2dSize*)b;
+  return x < y ? -1 : x > y;
+}
+
+//returns the node of the conjunction of children (which are reordered), dropping true children;
+//it is false if one of them is false, and the child itself if there is one left
+c2dSize nnf_and(NnfCircuit* circuit, c2dSize* children, c2dSize num_children) {
+  c2dSize size = 0;
+  for (c2dSize i = 0; i < num_children; i++) {
+    if (children[i] == NNF_FALSE) return NNF_FALSE;
+    if (children[i] != NNF_TRUE) children[size++] = children[i];
+  }
+  if (size == 0) return NNF_TRUE;
+  if (size == 1) return children[0];
+
+  // sorted children make equal conjunctions equal nodes
+  qsort(children, size, sizeof(c2dSize), compare_nodes);
+  c2dSize j = 1;
+  for (c2dSize i = 1; i < size; i++) {
+    if (children[i] != children[j - 1]) children[j++] = children[i];
+  }
+  return j == 1 ? children[0] : unique_node(circuit, NNF_AND, 0, children, j);
+}
+
+//returns the decision node on var: high (which must imply var) or low (which must imply its
+//negation); it is the other one if one of them is false
+c2dSize nnf_decision(NnfCircuit* circuit, c2dSize var, c2dSize high, c2dSize low) {
+  if (high == NNF_FALSE) return low;
+  if (low == NNF_FALSE) return high;
+  c2dSize children[2] = {high, low};
+  return unique_node(circuit, NNF_OR, (c2dLiteral)var, children, 2);
+}
+
+/******************************************************************************
+ * Compilation
+ ******************************************************************************/
+
+typedef struct compiler {
+  SatState* sat_state;
+  NnfCircuit* circuit;
+  ComponentStack* stack;
+  ComponentCache* cache;
+  Clause* learned;       // learned from the last conflict, until it is asserted
+  c2dSize* conjuncts;    // children of the and nodes being made, one range per frame
+  c2dSize num_conjuncts;
+  c2dSize conjuncts_cap;
+} Compiler;
+
+static void push_conjunct(Compiler* compiler, c2dSize node) {
+  if (compiler->num_conjuncts == compiler->conjuncts_cap) {
+    compiler->conjuncts_cap *= 2;
+    compiler->conjuncts = realloc(compiler->conjuncts, sizeof(c2dSize) * compiler->conjuncts_cap);
+  }
+  compiler->conjuncts[compiler->num_conjuncts++] = node;
+}
+
+// pushes the literals set among the variables of the component (all the variables for
+// NO_COMPONENT), which were free when it was found
+static void push_literals(Compiler* compiler, c2dSize component) {
+  const SatState* sat_state = compiler->sat_state;
+  c2dSize num_vars = sat_state->num_vars;
+  const c2dSize* vars = NULL;
+  if (component != NO_COMPONENT) vars = component_vars(compiler->stack, component, &num_vars);
+  for (c2dSize i = 0; i < num_vars; i++) {
+    c2dSize var = vars != NULL ? vars[i] : i + 1;
+    if (sat_state->levels[var] == 0 || sat_state->eliminated[var]) continue;
+    c2dLiteral literal = sat_state->values[2 * var] > 0 ? (c2dLiteral)var : -(c2dLiteral)var;
+    push_conjunct(compiler, nnf_literal(compiler->circuit, literal));
+  }
+}
+
+// returns the variable of the component to decide: the one occurring in most cnf clauses,
+// plus its activity relative to the current bump (VSADS)
+static c2dSize pick_var(const Compiler* compiler, const c2dSize* vars, c2dSize num_vars) {
+  const SatState* sat_state = compiler->sat_state;
+  c2dSize best = vars[0];
+  double best_score = -1;
+  for (c2dSize i = 0; i < num_vars; i++) {
+    c2dSize var = vars[i];
+    double score = sat_state->variables[var]->num_cnf_clauses + sat_state->activity[var] / sat_state->var_inc;
+    if (score > best_score) {
+      best = var;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+static c2dSize compile_frame(Compiler* compiler, c2dSize parent);
+
+// returns the node of the component, COMPILE_CONFLICT on a conflict
+static c2dSize compile_component(Compiler* compiler, c2dSize component) {
+  SatState* sat_state = compiler->sat_state;
+  c2dSize num_vars, num_clauses;
+  const c2dSize* vars = component_vars(compiler->stack, component, &num_vars);
+  const c2dSize* clauses = component_clauses(compiler->stack, component, &num_clauses);
+  if (num_clauses == 0) return NNF_TRUE;
+
+  c2dSize cached;
+  if (component_cache_lookup_node(compiler->cache, vars, num_vars, clauses, num_clauses, &cached)) {
+    return cached;
+  }
+
+  c2dSize var = pick_var(compiler, vars, num_vars);
+  c2dSize branches[2];
+  for (int positive = 1; positive >= 0; positive--) {
+    Lit* lit = positive ? sat_state->p_literals[var] : sat_state->n_literals[var];
+    Clause* learned = sat_decide_literal(lit, sat_state);
+    branches[positive] = learned != NULL ? COMPILE_CONFLICT : compile_frame(compiler, component);
+    sat_undo_decide_literal(sat_state);
+    if (learned != NULL) compiler->learned = learned;
+    if (branches[positive] == COMPILE_CONFLICT) return COMPILE_CONFLICT;
+  }
+  c2dSize node = nnf_decision(compiler->circuit, var, branches[1], branches[0]);
+
+  // the frames pushed meanwhile may have moved the arrays of the stack
+  vars = component_vars(compiler->stack, component, &num_vars);
+  clauses = component_clauses(compiler->stack, component, &num_clauses);
+  component_cache_store_node(compiler->cache, vars, num_vars, clauses, num_clauses, node);
+  return node;
+}
+
+// returns the conjunction of the literals set in the parent component (the whole cnf for
+// NO_COMPONENT) and of the components it falls into, COMPILE_CONFLICT on a conflict whose
+// learned clause asserts below the current level
+static c2dSize compile_frame(Compiler* compiler, c2dSize parent) {
+  SatState* sat_state = compiler->sat_state;
+  ComponentStack* stack = compiler->stack;
+  c2dSize start = compiler->num_conjuncts;
+
+  for (;;) {
+    c2dSize mark = component_cache_mark(compiler->cache);
+    if (parent == NO_COMPONENT) sat_components(sat_state, stack);
+    else sat_split_component(parent, sat_state, stack);
+    c2dSize first;
+    c2dSize num_components = component_stack_top(stack, &first);
+
+    push_literals(compiler, parent);
+    BOOLEAN conflict = 0;
+    for (c2dSize i = first; i < first + num_components && !conflict; i++) {
+      c2dSize node = compile_component(compiler, i);
+      if (node == COMPILE_CONFLICT) conflict = 1;
+      else push_conjunct(compiler, node);
+    }
+    component_stack_pop(stack);
+
+    if (!conflict) {
+      c2dSize node = nnf_and(compiler->circuit, compiler->conjuncts + start, compiler->num_conjuncts - start);
+      compiler->num_conjuncts = start;
+      return node;
+    }
+    compiler->num_conjuncts = start;
+
+    component_cache_forget(compiler->cache, mark);
+    while (compiler->learned != NULL) {
+      if (compiler->learned->assertion_level < sat_state->cur_level) return COMPILE_CONFLICT;
+      if (compiler->learned->size == 0) {
+        sat_state->inconsistent = 1;
+        compiler->learned = NULL;
+        return NNF_FALSE;
+      }
+      compiler->learned = sat_assert_clause(compiler->learned, sat_state);
+    }
+  }
+}
+
+//compiles the cnf of sat state into a Decision-DNNF, caching the compilation of components in
+//up to cache_budget bytes; the root is false if the cnf is unsatisfiable
+NnfCircuit* sat_compile(SatState* sat_state, c2dSize cache_budget) {
+  double start = sat_clock();
+  NnfCircuit* circuit = nnf_circuit_new(sat_state->num_vars);
+
+  sat_backtrack_to_level(1, sat_state);
+  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_FIRST_TIME && !sat_unit_resolution(sat_state)) {
+    sat_state->inconsistent = 1;
+  }
+  if (sat_state->inconsistent) {
+    circuit->root = NNF_FALSE;
+    circuit->compile_time = sat_clock() - start;
+    return circuit;
+  }
+
+  Compiler compiler;
+  compiler.sat_state = sat_state;
+  compiler.circuit = circuit;
+  compiler.stack = component_stack_new(sat_state);
+  compiler.cache = component_cache_new(cache_budget, CACHE_NODES);
+  compiler.learned = NULL;
+  compiler.num_conjuncts = 0;
+  compiler.conjuncts_cap = sat_state->num_vars + 16;
+  compiler.conjuncts = malloc(sizeof(c2dSize) * compiler.conjuncts_cap);
+
+  circuit->root = compile_frame(&compiler, NO_COMPONENT);
+
+  free(compiler.conjuncts);
+  component_cache_free(compiler.cache);
+  component_stack_free(compiler.stack);
+  circuit->compile_time = sat_clock() - start;
+  return circuit;
+}
+
+/******************************************************************************
+ * Output
+ ******************************************************************************/
+
+#define NNF_WRITE_BUFFER ((size_t)1 << 20)
+
+//writes the nodes reachable from the root in the NNF format of c2d, children first
+//returns 0 if the file cannot be written, 1 otherwise
+BOOLEAN nnf_write(const NnfCircuit* circuit, const char* file_name) {
+  FILE* file = fopen(file_name, "w");
+  if (file == NULL) return 0;
+  setvbuf(file, NULL, _IOFBF, NNF_WRITE_BUFFER);
+
+  // the parents come after their children, so a walk down from the root finds the nodes
+  // reachable from it; they are then numbered from the first one
+  c2dSize* ids = malloc(sizeof(c2dSize) * (circuit->root + 1));
+  for (c2dSize n = 0; n <= circuit->root; n++) ids[n] = NNF_NONE;
+  ids[circuit->root] = 0;
+  c2dSize num_nodes = 0, num_edges = 0;
+  for (c2dSize n = circuit->root + 1; n-- > 0;) {
+    if (ids[n] == NNF_NONE) continue;
+    const NnfNode* node = &(circuit->nodes[n]);
+    for (c2dSize i = 0; i < node->num_children; i++) ids[circuit->children[node->children + i]] = 0;
+    num_edges += node->num_children;
+  }
+  for (c2dSize n = 0; n <= circuit->root; n++) {
+    if (ids[n] != NNF_NONE) ids[n] = num_nodes++;
+  }
+
+  fprintf(file, "nnf %lu %lu %lu\n", num_nodes, num_edges, circuit->num_vars);
+  for (c2dSize n = 0; n <= circuit->root; n++) {
+    if (ids[n] == NNF_NONE) continue;
+    const NnfNode* node = &(circuit->nodes[n]);
+    const c2dSize* children = circuit->children + node->children;
+    if (node->kind == NNF_LITERAL) {
+      fprintf(file, "L %ld\n", node->literal);
+      continue;
+    }
+    if (node->kind == NNF_AND) fprintf(file, "A %lu", node->num_children);
+    else fprintf(file, "O %ld %lu", node->literal, node->num_children);
+    for (c2dSize i = 0; i < node->num_children; i++) fprintf(file, " %lu", ids[children[i]]);
+    fputc('\n', file);
+  }
+  free(ids);
+
+  BOOLEAN ok = !ferror(file);
+  return fclose(file) == 0 && ok;
+}
+
+//prints the size of the circuit and the time it took to compile
+void nnf_print_stats(const NnfCircuit* circuit, FILE* file) {
+  fprintf(file, "c nnf: %lu nodes, %lu edges, %lu nodes shared\n", circuit->num_nodes, circuit->num_children,
+          circuit->num_shared);
+  fprintf(file, "c nnf: compiled in %.3f s\n", circuit->compile_time);
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,188 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Components
+ *
+ * A split walks the free variables of the component given to it, through the
+ * occurrence lists of the variables (Var::clauses, the cnf clauses only), and
+ * only follows the clauses which are not subsumed. The variables still to be
+ * reached are the marked ones, a clause already reached is marked as well, so a
+ * split costs the occurrences of the variables of the component and never looks
+ * at the rest of the cnf.
+ *
+ * The children of a component are a partition of its free variables and a subset
+ * of its clauses, which bounds the room a split takes: the arrays of the stack
+ * only grow when a frame does not fit, and are never shrunk, so in steady state a
+ * split does not allocate.
+ ******************************************************************************/
+
+//returns an empty component stack for the cnf of sat state
+ComponentStack* component_stack_new(const SatState* sat_state) {
+  ComponentStack* stack = malloc(sizeof(ComponentStack));
+  stack->num_components = 0;
+  stack->components_cap = 16;
+  stack->components = malloc(sizeof(Component) * stack->components_cap);
+  stack->num_frames = 0;
+  stack->frames_cap = 16;
+  stack->frames = malloc(sizeof(c2dSize) * stack->frames_cap);
+  stack->num_vars = 0;
+  stack->vars_cap = 2 * (sat_state->num_vars + 1);
+  stack->vars = malloc(sizeof(c2dSize) * stack->vars_cap);
+  stack->num_clauses = 0;
+  stack->clauses_cap = 2 * (sat_state->num_cnf_clauses + 1);
+  stack->clauses = malloc(sizeof(c2dSize) * stack->clauses_cap);
+  return stack;
+}
+
+//frees a component stack
+void component_stack_free(ComponentStack* stack) {
+  free(stack->components);
+  free(stack->frames);
+  free(stack->vars);
+  free(stack->clauses);
+  free(stack);
+}
+
+// makes room for a frame of up to num_vars variables and num_clauses clauses
+static void reserve_frame(ComponentStack* stack, c2dSize num_vars, c2dSize num_clauses) {
+  if (stack->num_frames == stack->frames_cap) {
+    stack->frames_cap *= 2;
+    stack->frames = realloc(stack->frames, sizeof(c2dSize) * stack->frames_cap);
+  }
+  if (stack->num_vars + num_vars > stack->vars_cap) {
+    while (stack->num_vars + num_vars > stack->vars_cap) stack->vars_cap *= 2;
+    stack->vars = realloc(stack->vars, sizeof(c2dSize) * stack->vars_cap);
+  }
+  if (stack->num_clauses + num_clauses > stack->clauses_cap) {
+    while (stack->num_clauses + num_clauses > stack->clauses_cap) stack->clauses_cap *= 2;
+    stack->clauses = realloc(stack->clauses, sizeof(c2dSize) * stack->clauses_cap);
+  }
+}
+
+static Component* push_component(ComponentStack* stack) {
+  if (stack->num_components == stack->components_cap) {
+    stack->components_cap *= 2;
+    stack->components = realloc(stack->components, sizeof(Component) * stack->components_cap);
+  }
+  Component* component = &(stack->components[stack->num_components++]);
+  component->vars_start = stack->num_vars;
+  component->num_vars = 0;
+  component->clauses_start = stack->num_clauses;
+  component->num_clauses = 0;
+  return component;
+}
+
+static inline BOOLEAN clause_satisfied(const Clause* clause, const SatState* sat_state) {
+  if (sat_state->true_counts != NULL) return sat_state->true_counts[clause->index] > 0;
+  for (c2dSize i = 0; i < clause->size; i++) {
+    if (sat_state->values[clause->lits[i]] > 0) return 1;
+  }
+  return 0;
+}
+
+// splits the marked variables of candidates into components, pushed as a new frame; the
+// marks of the variables are cleared on the way, and the marks of the clauses at the end
+static c2dSize split(const c2dSize* candidates, c2dSize num_candidates, SatState* sat_state,
+                     ComponentStack* stack) {
+  stack->frames[stack->num_frames++] = stack->num_components;
+  c2dSize frame_clauses = stack->num_clauses;
+
+  for (c2dSize c = 0; c < num_candidates; c++) {
+    Var* seed = sat_state->variables[candidates[c]];
+    if (!seed->mark) continue;
+    Component* component = push_component(stack);
+    seed->mark = 0;
+    stack->vars[stack->num_vars++] = seed->index;
+
+    // the variables of the component are its queue
+    for (c2dSize q = component->vars_start; q < stack->num_vars; q++) {
+      Var* var = sat_state->variables[stack->vars[q]];
+      for (c2dSize i = 0; i < var->num_cnf_clauses; i++) {
+        Clause* clause = var->clauses[i];
+        if (clause->mark || clause_satisfied(clause, sat_state)) continue;
+        clause->mark = 1;
+        stack->clauses[stack->num_clauses++] = clause->index;
+        for (c2dSize j = 0; j < clause->size; j++) {
+          Var* other = sat_state->variables[code_var(clause->lits[j])];
+          if (!other->mark) continue;
+          other->mark = 0;
+          stack->vars[stack->num_vars++] = other->index;
+        }
+      }
+    }
+    component->num_vars = stack->num_vars - component->vars_start;
+    component->num_clauses = stack->num_clauses - component->clauses_start;
+  }
+
+  for (c2dSize i = frame_clauses; i < stack->num_clauses; i++) {
+    sat_state->cnf_clauses[stack->clauses[i]]->mark = 0;
+  }
+  return stack->num_components - stack->frames[stack->num_frames - 1];
+}
+
+//pushes a frame with the components of the cnf of sat state under its current assignment:
+//its free variables (eliminated ones aside), connected by the cnf clauses which are not
+//subsumed; a variable in no such clause is a component of its own
+//returns the number of components of the frame
+c2dSize sat_components(SatState* sat_state, ComponentStack* stack) {
+  // the candidates are kept right after the room of the frame
+  reserve_frame(stack, 2 * sat_state->num_vars, sat_state->num_cnf_clauses);
+  c2dSize* candidates = stack->vars + stack->num_vars + sat_state->num_vars;
+  c2dSize num_candidates = 0;
+  for (c2dSize var = 1; var <= sat_state->num_vars; var++) {
+    if (sat_state->levels[var] != 0 || sat_state->eliminated[var]) continue;
+    sat_state->variables[var]->mark = 1;
+    candidates[num_candidates++] = var;
+  }
+  return split(candidates, num_candidates, sat_state, stack);
+}
+
+//pushes a frame with the components the given component (of an earlier frame) falls into under
+//the current assignment of sat state, which must extend the one the component was found under
+//returns the number of components of the frame
+c2dSize sat_split_component(c2dSize component, SatState* sat_state, ComponentStack* stack) {
+  const Component* parent = &(stack->components[component]);
+  reserve_frame(stack, parent->num_vars, parent->num_clauses);
+  parent = &(stack->components[component]);
+  const c2dSize* candidates = stack->vars + parent->vars_start;
+  for (c2dSize i = 0; i < parent->num_vars; i++) {
+    if (sat_state->levels[candidates[i]] == 0) sat_state->variables[candidates[i]]->mark = 1;
+  }
+  return split(candidates, parent->num_vars, sat_state, stack);
+}
+
+//pops the last frame of the stack
+void component_stack_pop(ComponentStack* stack) {
+  if (stack->num_frames == 0) return;
+  stack->num_components = stack->frames[--stack->num_frames];
+  if (stack->num_components == 0) {
+    stack->num_vars = 0;
+    stack->num_clauses = 0;
+    return;
+  }
+  const Component* last = &(stack->components[stack->num_components - 1]);
+  stack->num_vars = last->vars_start + last->num_vars;
+  stack->num_clauses = last->clauses_start + last->num_clauses;
+}
+
+//returns the number of components of the last frame, and sets *first to the first one
+c2dSize component_stack_top(const ComponentStack* stack, c2dSize* first) {
+  *first = stack->num_frames > 0 ? stack->frames[stack->num_frames - 1] : 0;
+  return stack->num_components - *first;
+}
+
+//returns the variable indices of a component, and sets *size to their number
+const c2dSize* component_vars(const ComponentStack* stack, c2dSize component, c2dSize* size) {
+  *size = stack->components[component].num_vars;
+  return stack->vars + stack->components[component].vars_start;
+}
+
+//returns the cnf clause indices of a component, and sets *size to their number
+const c2dSize* component_clauses(const ComponentStack* stack, c2dSize component, c2dSize* size) {
+  *size = stack->components[component].num_clauses;
+  return stack->clauses + stack->components[component].clauses_start;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
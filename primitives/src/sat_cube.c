@@ -0,0 +1,365 @@
+#include <pthread.h>
+#include "sat_api.h"
+
+/******************************************************************************
+ * Cube and conquer
+ *
+ * Cubes: the cnf is split by deciding variables both ways up to a depth, each
+ * path of the split being a cube (a conjunction of literals). The variable of a
+ * split is picked by lookahead: the candidates are decided both ways, and the
+ * one which implies the most literals on both sides wins. A literal which fails
+ * during lookahead forces the other value on the path, and a path where both
+ * values fail is refuted, so it gives no cube.
+ *
+ * Conquer: each worker thread has its own sat state and a deque of cubes, which
+ * it solves as assumptions, from the bottom of its deque; an idle worker steals
+ * from the top of the deque of another one. The units learned by a worker are
+ * passed to the others through a clause exchange, and picked up before each
+ * cube. The first satisfiable cube, or a conflict which does not depend on the
+ * cube, stops all workers.
+ ******************************************************************************/
+
+#define LOOKAHEAD_CANDIDATES 16  // variables tried by lookahead at each split
+
+/******************************************************************************
+ * Cubes
+ ******************************************************************************/
+
+static CubeSet* cube_set_new(void) {
+  CubeSet* cubes = malloc(sizeof(CubeSet));
+  cubes->num_cubes = 0;
+  cubes->cap = 16;
+  cubes->starts = malloc(sizeof(c2dSize) * (cubes->cap + 1));
+  cubes->starts[0] = 0;
+  cubes->lits_cap = 64;
+  cubes->lits = malloc(sizeof(c2dLiteral) * cubes->lits_cap);
+  cubes->results = NULL;
+  cubes->times = NULL;
+  return cubes;
+}
+
+static void cube_set_push(CubeSet* cubes, const c2dLiteral* lits, c2dSize size) {
+  if (cubes->num_cubes == cubes->cap) {
+    cubes->cap *= 2;
+    cubes->starts = realloc(cubes->starts, sizeof(c2dSize) * (cubes->cap + 1));
+  }
+  c2dSize start = cubes->starts[cubes->num_cubes];
+  while (start + size > cubes->lits_cap) {
+    cubes->lits_cap *= 2;
+    cubes->lits = realloc(cubes->lits, sizeof(c2dLiteral) * cubes->lits_cap);
+  }
+  memcpy(cubes->lits + start, lits, sizeof(c2dLiteral) * size);
+  cubes->starts[++cubes->num_cubes] = start + size;
+}
+
+//frees a cube set
+void cube_set_free(CubeSet* cubes) {
+  free(cubes->starts);
+  free(cubes->lits);
+  free(cubes->results);
+  free(cubes->times);
+  free(cubes);
+}
+
+typedef struct cube_split {
+  SatState* sat_state;
+  CubeSet* cubes;
+  c2dSize max_depth;
+  c2dSize* candidates;    // variables by decreasing number of occurrences
+  c2dLiteral* path;       // literals decided from the first level
+  c2dSize path_size;
+} CubeSplit;
+
+// decides lit, and returns the number of literals it implies, or -1 if it fails
+// the sat state is left as it was
+static long lookahead(Lit* lit, SatState* sat_state) {
+  c2dSize start = sat_state->trail_size;
+  Clause* learned = sat_decide_literal(lit, sat_state);
+  long implied = learned == NULL ? (long)(sat_state->trail_size - start) : -1;
+  sat_undo_decide_literal(sat_state);
+  return implied;
+}
+
+// returns the literal to split on, 0 if all variables are instantiated; sets *forced if the
+// opposite literal failed, so only the returned literal is left to explore, and *refuted if both
+// literals of a variable failed
+static c2dLiteral pick_split(CubeSplit* split, BOOLEAN* forced, BOOLEAN* refuted) {
+  SatState* sat_state = split->sat_state;
+  c2dLiteral best = 0;
+  double best_score = -1;
+  c2dSize num_tried = 0;
+  *forced = *refuted = 0;
+
+  for (c2dSize i = 0; i < sat_state->num_vars && num_tried < LOOKAHEAD_CANDIDATES; i++) {
+    c2dSize var = split->candidates[i];
+    if (sat_state->levels[var] != 0 || sat_state->eliminated[var]) continue;
+    ++num_tried;
+    long pos = lookahead(sat_state->p_literals[var], sat_state);
+    long neg = lookahead(sat_state->n_literals[var], sat_state);
+    if (pos < 0 && neg < 0) {
+      *refuted = 1;
+      return 0;
+    }
+    if (pos < 0 || neg < 0) {
+      *forced = 1;
+      return pos < 0 ? -(c2dLiteral)var : (c2dLiteral)var;
+    }
+    double score = (double)(pos + 1) * (neg + 1);
+    if (score > best_score) {
+      best_score = score;
+      best = (c2dLiteral)var;
+    }
+  }
+  return best;
+}
+
+static void split_cubes(CubeSplit* split, c2dSize depth);
+
+// decides lit on the path and splits below it, unless it fails
+static void split_below(CubeSplit* split, c2dLiteral lit, c2dSize depth) {
+  SatState* sat_state = split->sat_state;
+  if (sat_decide_literal(sat_index2literal(lit, sat_state), sat_state) == NULL) {
+    split->path[split->path_size++] = lit;
+    split_cubes(split, depth);
+    --split->path_size;
+  }
+  sat_undo_decide_literal(sat_state);
+}
+
+// the literals forced by lookahead are decided in place, so they do not add to the recursion
+static void split_cubes(CubeSplit* split, c2dSize depth) {
+  SatState* sat_state = split->sat_state;
+  c2dSize path_size = split->path_size;
+  c2dSize num_forced = 0;
+
+  for (;;) {
+    if (depth == split->max_depth) {
+      cube_set_push(split->cubes, split->path, split->path_size);
+      break;
+    }
+    BOOLEAN forced, refuted;
+    c2dLiteral lit = pick_split(split, &forced, &refuted);
+    if (refuted) break;
+    if (lit == 0) {
+      // every variable is instantiated, the path is a model
+      cube_set_push(split->cubes, split->path, split->path_size);
+      break;
+    }
+    if (!forced) {
+      split_below(split, lit, depth + 1);
+      split_below(split, -lit, depth + 1);
+      break;
+    }
+    ++num_forced;
+    split->path[split->path_size++] = lit;
+    if (sat_decide_literal(sat_index2literal(lit, sat_state), sat_state) != NULL) break;
+  }
+
+  while (num_forced-- > 0) sat_undo_decide_literal(sat_state);
+  split->path_size = path_size;
+}
+
+//splits the cnf of sat state into cubes of max_depth split literals (besides the literals
+//forced by lookahead); the cnf is unsatisfiable if and only if every cube is
+//the sat state is left at the first decision level
+CubeSet* sat_lookahead_cubes(SatState* sat_state, c2dSize max_depth) {
+  CubeSet* cubes = cube_set_new();
+  sat_backtrack_to_level(1, sat_state);
+  if (sat_state->inconsistent ||
+      (sat_state->unit_resolution_s == UNIT_RESOLUTION_FIRST_TIME && !sat_unit_resolution(sat_state))) {
+    sat_state->inconsistent = 1;
+    return cubes;
+  }
+
+  CubeSplit split;
+  split.sat_state = sat_state;
+  split.cubes = cubes;
+  split.max_depth = max_depth;
+  split.path = malloc(sizeof(c2dLiteral) * (sat_state->num_vars + 1));
+  split.path_size = 0;
+
+  // Counting sort of the variables by number of occurrences, the most frequent first
+  c2dSize max_occurrences = 0;
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
+    if (sat_state->variables[i]->num_cnf_clauses > max_occurrences) {
+      max_occurrences = sat_state->variables[i]->num_cnf_clauses;
+    }
+  }
+  c2dSize* counts = calloc(max_occurrences + 2, sizeof(c2dSize));
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
+    ++counts[max_occurrences - sat_state->variables[i]->num_cnf_clauses + 1];
+  }
+  for (c2dSize i = 1; i <= max_occurrences + 1; i++) counts[i] += counts[i - 1];
+  split.candidates = malloc(sizeof(c2dSize) * (sat_state->num_vars + 1));
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
+    split.candidates[counts[max_occurrences - sat_state->variables[i]->num_cnf_clauses]++] = i;
+  }
+  free(counts);
+
+  split_cubes(&split, 0);
+
+  free(split.path);
+  free(split.candidates);
+  return cubes;
+}
+
+/******************************************************************************
+ * Conquer
+ ******************************************************************************/
+
+typedef struct cube_deque {
+  pthread_mutex_t lock;
+  c2dSize* cubes;
+  c2dSize top;     // thieves take cubes[top]
+  c2dSize bottom;  // the owner takes cubes[bottom - 1]
+} CubeDeque;
+
+typedef struct cube_pool {
+  const DimacsCnf* cnf;
+  CubeSet* cubes;
+  ClauseExchange* exchange;  // learned units
+  CubeDeque* deques;         // one per worker
+  c2dSize num_workers;
+  double deadline;           // 0 if unlimited
+  volatile BOOLEAN stop;
+  pthread_mutex_t lock;      // protects result and model
+  int result;
+  BOOLEAN* model;
+} CubePool;
+
+typedef struct cube_worker {
+  CubePool* pool;
+  c2dSize id;
+  pthread_t thread;
+} CubeWorker;
+
+// returns the next cube for worker id, from its own deque first, or (c2dSize)-1 if none is left
+static c2dSize next_cube(CubePool* pool, c2dSize id) {
+  CubeDeque* own = &(pool->deques[id]);
+  c2dSize cube = (c2dSize)-1;
+  pthread_mutex_lock(&(own->lock));
+  if (own->top < own->bottom) cube = own->cubes[--own->bottom];
+  pthread_mutex_unlock(&(own->lock));
+
+  for (c2dSize i = 1; i < pool->num_workers && cube == (c2dSize)-1; i++) {
+    CubeDeque* victim = &(pool->deques[(id + i) % pool->num_workers]);
+    pthread_mutex_lock(&(victim->lock));
+    if (victim->top < victim->bottom) cube = victim->cubes[victim->top++];
+    pthread_mutex_unlock(&(victim->lock));
+  }
+  return cube;
+}
+
+// records the answer of the first worker which has one, and stops the others
+static void finish(CubePool* pool, int result, const SatState* sat_state) {
+  pthread_mutex_lock(&(pool->lock));
+  if (pool->result == SAT_UNKNOWN) {
+    pool->result = result;
+    if (result == SAT_SATISFIABLE && pool->model != NULL) {
+      memcpy(pool->model, sat_model(sat_state), sizeof(BOOLEAN) * (pool->cnf->num_vars + 1));
+    }
+  }
+  __atomic_store_n(&(pool->stop), 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&(pool->lock));
+}
+
+static void* cube_worker_run(void* arg) {
+  CubeWorker* worker = arg;
+  CubePool* pool = worker->pool;
+  CubeSet* cubes = pool->cubes;
+
+  SatState* sat_state = sat_state_new_from_cnf(pool->cnf);
+  sat_set_interrupt(sat_state, &(pool->stop));
+  sat_set_clause_exchange(sat_state, pool->exchange, worker->id);
+
+  c2dSize cube;
+  while (!__atomic_load_n(&(pool->stop), __ATOMIC_ACQUIRE) && (cube = next_cube(pool, worker->id)) != (c2dSize)-1) {
+    double start = sat_clock();
+    if (pool->deadline > 0) {
+      if (start >= pool->deadline) break;
+      sat_set_solve_limits(sat_state, 0, 0, pool->deadline - start);
+    }
+
+    sat_backtrack_to_level(1, sat_state);
+    int result = SAT_UNSATISFIABLE;
+    if (sat_state->unit_resolution_s == UNIT_RESOLUTION_FIRST_TIME || sat_import_clauses(sat_state)) {
+      c2dSize num_lits = cubes->starts[cube + 1] - cubes->starts[cube];
+      result = sat_solve_with_assumptions(cubes->lits + cubes->starts[cube], num_lits, sat_state);
+    }
+    cubes->results[cube] = result;
+    cubes->times[cube] = sat_clock() - start;
+
+    if (result == SAT_SATISFIABLE) finish(pool, result, sat_state);
+    if (result == SAT_UNSATISFIABLE && sat_state->inconsistent) finish(pool, result, sat_state);
+  }
+
+  sat_state_free(sat_state);
+  return NULL;
+}
+
+//solves the cubes of the cnf with num_threads workers, within seconds (0 for no limit); the
+//result and the time of each cube are recorded in cubes (SAT_UNKNOWN for the cubes which were
+//not solved); on SAT_SATISFIABLE, model (num_vars + 1 entries) receives the model by variable
+//returns SAT_SATISFIABLE, SAT_UNSATISFIABLE, or SAT_UNKNOWN when the time runs out
+int sat_solve_cubes(const DimacsCnf* cnf, CubeSet* cubes, c2dSize num_threads, double seconds, BOOLEAN* model) {
+  if (num_threads == 0) num_threads = 1;
+  free(cubes->results);
+  free(cubes->times);
+  cubes->results = calloc(cubes->num_cubes + 1, sizeof(int));
+  cubes->times = calloc(cubes->num_cubes + 1, sizeof(double));
+
+  CubePool pool;
+  pool.cnf = cnf;
+  pool.cubes = cubes;
+  pool.exchange = clause_exchange_new(num_threads, 1, 1);
+  pool.num_workers = num_threads;
+  pool.deadline = seconds > 0 ? sat_clock() + seconds : 0;
+  pool.stop = 0;
+  pthread_mutex_init(&(pool.lock), NULL);
+  pool.result = SAT_UNKNOWN;
+  pool.model = model;
+
+  // Each worker starts with a contiguous range of cubes, the first one at the bottom
+  pool.deques = malloc(sizeof(CubeDeque) * num_threads);
+  c2dSize* order = malloc(sizeof(c2dSize) * (cubes->num_cubes + 1));
+  for (c2dSize i = 0, next = 0; i < num_threads; i++) {
+    c2dSize end = cubes->num_cubes * (i + 1) / num_threads;
+    CubeDeque* deque = &(pool.deques[i]);
+    pthread_mutex_init(&(deque->lock), NULL);
+    deque->cubes = order + next;
+    deque->top = 0;
+    deque->bottom = end - next;
+    for (c2dSize j = 0; next < end; j++) deque->cubes[deque->bottom - 1 - j] = next++;
+  }
+
+  CubeWorker* workers = malloc(sizeof(CubeWorker) * num_threads);
+  c2dSize num_started = 0;
+  for (c2dSize i = 0; i < num_threads; i++) {
+    workers[i].pool = &pool;
+    workers[i].id = i;
+    if (pthread_create(&(workers[i].thread), NULL, cube_worker_run, &(workers[i])) != 0) break;
+    ++num_started;
+  }
+  // The cubes of the workers which could not be started are stolen by the others
+  if (num_started == 0) cube_worker_run(&(workers[0]));
+  for (c2dSize i = 0; i < num_started; i++) pthread_join(workers[i].thread, NULL);
+
+  if (pool.result == SAT_UNKNOWN) {
+    pool.result = SAT_UNSATISFIABLE;
+    for (c2dSize i = 0; i < cubes->num_cubes; i++) {
+      if (cubes->results[i] != SAT_UNSATISFIABLE) pool.result = SAT_UNKNOWN;
+    }
+  }
+
+  for (c2dSize i = 0; i < num_threads; i++) pthread_mutex_destroy(&(pool.deques[i].lock));
+  free(pool.deques);
+  free(order);
+  free(workers);
+  clause_exchange_free(pool.exchange);
+  pthread_mutex_destroy(&(pool.lock));
+  return pool.result;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,125 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Clause exchange
+ *
+ * Every ring has a single writer, the sat state which owns it, so writing is a
+ * few stores and never waits for the readers. A reader copies a slot and then
+ * checks that its sequence number did not change in the meantime (as with a
+ * seqlock); a slot which was overwritten is skipped, it only costs a clause.
+ *
+ * The ordering between the sequence numbers and the literals is given by the
+ * atomic builtins of gcc, the literals themselves are read and written with
+ * relaxed atomic accesses.
+ ******************************************************************************/
+
+//returns a clause exchange between num_searches sat states, which shares the learned clauses
+//with an lbd up to max_lbd and a size up to max_size (at most EXCHANGE_MAX_SIZE)
+ClauseExchange* clause_exchange_new(c2dSize num_searches, unsigned int max_lbd, unsigned int max_size) {
+  ClauseExchange* exchange = malloc(sizeof(ClauseExchange));
+  exchange->num_rings = num_searches;
+  exchange->rings = malloc(sizeof(ExchangeRing) * num_searches);
+  for (c2dSize i = 0; i < num_searches; i++) {
+    exchange->rings[i].head = 0;
+    exchange->rings[i].slots = calloc(EXCHANGE_RING_SIZE, sizeof(ExchangeSlot));
+  }
+  exchange->max_lbd = max_lbd;
+  exchange->max_size = max_size < EXCHANGE_MAX_SIZE ? max_size : EXCHANGE_MAX_SIZE;
+  return exchange;
+}
+
+//frees the clause exchange, once no sat state uses it
+void clause_exchange_free(ClauseExchange* exchange) {
+  for (c2dSize i = 0; i < exchange->num_rings; i++) free(exchange->rings[i].slots);
+  free(exchange->rings);
+  free(exchange);
+}
+
+//attaches sat state to the clause exchange, as search id (from 0 to num_searches - 1)
+void sat_set_clause_exchange(SatState* sat_state, ClauseExchange* exchange, c2dSize id) {
+  sat_state->exchange = exchange;
+  sat_state->exchange_id = id;
+  free(sat_state->import_positions);
+  sat_state->import_positions = calloc(exchange->num_rings, sizeof(unsigned long));
+  for (c2dSize i = 0; i < exchange->num_rings; i++) {
+    sat_state->import_positions[i] = __atomic_load_n(&(exchange->rings[i].head), __ATOMIC_ACQUIRE);
+  }
+}
+
+// writes a clause learned by sat state to its ring, if it passes the filter
+void export_clause(const Clause* clause, SatState* sat_state) {
+  ClauseExchange* exchange = sat_state->exchange;
+  if (clause->size > exchange->max_size || clause->lbd > exchange->max_lbd) return;
+
+  ExchangeRing* ring = &(exchange->rings[sat_state->exchange_id]);
+  unsigned long position = ring->head;
+  ExchangeSlot* slot = &(ring->slots[position % EXCHANGE_RING_SIZE]);
+  __atomic_store_n(&(slot->seq), 2 * position + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&(slot->size), clause->size, __ATOMIC_RELAXED);
+  for (c2dSize i = 0; i < clause->size; i++) {
+    __atomic_store_n(&(slot->lits[i]), clause->lits[i], __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&(slot->seq), 2 * position + 2, __ATOMIC_RELEASE);
+  __atomic_store_n(&(ring->head), position + 1, __ATOMIC_RELEASE);
+  ++sat_state->num_exported;
+}
+
+// copies the clause at position of ring to lits, returns its size, or -1 if the slot has
+// been overwritten
+static long read_slot(const ExchangeRing* ring, unsigned long position, c2dLitCode* lits) {
+  const ExchangeSlot* slot = &(ring->slots[position % EXCHANGE_RING_SIZE]);
+  unsigned long seq = __atomic_load_n(&(slot->seq), __ATOMIC_ACQUIRE);
+  if (seq != 2 * position + 2) return -1;
+  unsigned int size = __atomic_load_n(&(slot->size), __ATOMIC_RELAXED);
+  if (size > EXCHANGE_MAX_SIZE) return -1;
+  for (unsigned int i = 0; i < size; i++) lits[i] = __atomic_load_n(&(slot->lits[i]), __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (__atomic_load_n(&(slot->seq), __ATOMIC_RELAXED) != seq) return -1;
+  return size;
+}
+
+// drops the literals of clause which are false at the first decision level
+// returns the new size, or -1 if the clause is satisfied there, or cannot be used by sat state
+static long simplify_imported(c2dLitCode* lits, c2dSize size, const SatState* sat_state) {
+  c2dSize j = 0;
+  for (c2dSize i = 0; i < size; i++) {
+    c2dSize var = code_var(lits[i]);
+    if (var == 0 || var > sat_state->num_vars || sat_state->eliminated[var]) return -1;
+    if (sat_state->values[lits[i]] > 0) return -1;
+    if (sat_state->values[lits[i]] == 0) lits[j++] = lits[i];
+  }
+  return j;
+}
+
+//learns the clauses exported by the other sat states since the last call, at the first
+//decision level, where the sat state must be
+//returns 0 if the cnf is found unsatisfiable, 1 otherwise
+BOOLEAN sat_import_clauses(SatState* sat_state) {
+  ClauseExchange* exchange = sat_state->exchange;
+  if (sat_state->inconsistent) return 0;
+  if (exchange == NULL) return 1;
+  c2dLitCode lits[EXCHANGE_MAX_SIZE];
+
+  for (c2dSize r = 0; r < exchange->num_rings; r++) {
+    if (r == sat_state->exchange_id) continue;
+    const ExchangeRing* ring = &(exchange->rings[r]);
+    unsigned long head = __atomic_load_n(&(ring->head), __ATOMIC_ACQUIRE);
+    unsigned long position = sat_state->import_positions[r];
+    if (head - position > EXCHANGE_RING_SIZE) position = head - EXCHANGE_RING_SIZE;
+
+    for (; position < head; position++) {
+      long size = read_slot(ring, position, lits);
+      if (size >= 0) size = simplify_imported(lits, size, sat_state);
+      if (size < 0) continue;
+      ++sat_state->num_imported;
+      if (!learn_implied_clause(lits, size, sat_state)) return 0;
+    }
+    sat_state->import_positions[r] = position;
+  }
+  return 1;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
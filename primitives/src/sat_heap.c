@@ -0,0 +1,74 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Variable heap
+ *
+ * A binary max-heap of variables ordered by activity. positions[var] is the
+ * place of the variable in the heap (starting from 1), 0 when it is not in the
+ * heap, so that a variable can be moved up when its activity is bumped.
+ *
+ * Instantiated variables are not removed eagerly: they are skipped when they
+ * reach the top, and put back when they are uninstantiated.
+ ******************************************************************************/
+
+void var_heap_init(VarHeap* heap, c2dSize num_vars) {
+  heap->size = 0;
+  heap->vars = malloc(sizeof(c2dSize) * (num_vars + 1));
+  heap->positions = calloc(num_vars + 1, sizeof(c2dSize));
+}
+
+static inline void heap_place(VarHeap* heap, c2dSize pos, c2dSize var) {
+  heap->vars[pos] = var;
+  heap->positions[var] = pos;
+}
+
+static void heap_up(VarHeap* heap, c2dSize pos, const double* activity) {
+  c2dSize var = heap->vars[pos];
+  while (pos > 1 && activity[heap->vars[pos / 2]] < activity[var]) {
+    heap_place(heap, pos, heap->vars[pos / 2]);
+    pos /= 2;
+  }
+  heap_place(heap, pos, var);
+}
+
+static void heap_down(VarHeap* heap, c2dSize pos, const double* activity) {
+  c2dSize var = heap->vars[pos];
+  for (c2dSize child; (child = 2 * pos) <= heap->size; pos = child) {
+    if (child < heap->size && activity[heap->vars[child + 1]] > activity[heap->vars[child]]) ++child;
+    if (activity[heap->vars[child]] <= activity[var]) break;
+    heap_place(heap, pos, heap->vars[child]);
+  }
+  heap_place(heap, pos, var);
+}
+
+void var_heap_insert(VarHeap* heap, c2dSize var, const double* activity) {
+  if (heap->positions[var] != 0) return;
+  heap_place(heap, ++heap->size, var);
+  heap_up(heap, heap->size, activity);
+}
+
+// restores the heap order after the activity of var has been increased
+void var_heap_increased(VarHeap* heap, c2dSize var, const double* activity) {
+  if (heap->positions[var] != 0) heap_up(heap, heap->positions[var], activity);
+}
+
+// removes and returns the variable with the highest activity, 0 if the heap is empty
+c2dSize var_heap_pop(VarHeap* heap, const double* activity) {
+  if (heap->size == 0) return 0;
+  c2dSize top = heap->vars[1];
+  heap->positions[top] = 0;
+  if (--heap->size > 0) {
+    heap_place(heap, 1, heap->vars[heap->size + 1]);
+    heap_down(heap, 1, activity);
+  }
+  return top;
+}
+
+void var_heap_release(VarHeap* heap) {
+  free(heap->vars);
+  free(heap->positions);
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,586 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sat_api.h"
+
+/******************************************************************************
+ * DIMACS parser
+ *
+ * A file is mapped into memory and scanned once. Clauses are collected into a
+ * flat array of literal codes (each clause terminated by 0, which is not a valid
+ * literal code), and the occurrences of every variable are counted on the way,
+ * so that the sat state can size its lists exactly when it is built.
+ *
+ * Pipes and compressed files are read in chunks instead. A chunk always ends
+ * with a complete line, so the scanner never sees a token cut in two; the rest
+ * of the line is carried over to the next chunk.
+ *
+ * Weight lines fill a dense array of weights by literal code, allocated with the
+ * first one, so a weight is looked up with a single load. They may come after the
+ * last clause, hence the scanner goes on reading comments and weights there, up
+ * to the first other line. Weight lines before the header are kept aside, and
+ * set once the header gives the number of variables.
+ ******************************************************************************/
+
+#define STREAM_CHUNK ((c2dSize)1 << 20)
+
+double sat_clock(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct early_weight {
+  c2dLiteral lit;
+  double weight;
+  BOOLEAN complement;
+} EarlyWeight;
+
+typedef struct dimacs_parser {
+  DimacsCnf* cnf;
+  c2dSize clause_count;  // number of complete clauses
+  c2dSize clause_size;   // number of literals of the clause being read
+  BOOLEAN done;          // all clauses announced by the header have been read
+  BOOLEAN finished;      // a line other than a comment or a weight came after the last clause
+  BOOLEAN weighted;      // a weight line, or a "c t wmc" line, has been read
+  BOOLEAN error;
+  EarlyWeight* early_weights;  // weight lines read before the header
+  c2dSize num_early_weights;
+  c2dSize early_weights_cap;
+} DimacsParser;
+
+static void dimacs_push(DimacsCnf* cnf, c2dLitCode code) {
+  if (cnf->num_codes == cnf->codes_cap) {
+    cnf->codes_cap *= 2;
+    cnf->codes = realloc(cnf->codes, sizeof(c2dLitCode) * cnf->codes_cap);
+  }
+  cnf->codes[cnf->num_codes++] = code;
+}
+
+static inline BOOLEAN is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline BOOLEAN is_digit(char c) {
+  return '0' <= c && c <= '9';
+}
+
+static inline const char* skip_blanks(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t')) ++p;
+  return p;
+}
+
+// reads an unsigned integer, returns NULL if there is none
+static inline const char* scan_number(const char* p, const char* end, c2dSize* num) {
+  p = skip_blanks(p, end);
+  if (p == end || !is_digit(*p)) return NULL;
+  c2dSize ret = 0;
+  while (p < end && is_digit(*p)) ret = ret * 10 + (c2dSize)(*p++ - '0');
+  *num = ret;
+  return p;
+}
+
+static inline const char* skip_line(const char* p, const char* end) {
+  while (p < end && *p != '\n') ++p;
+  return p;
+}
+
+// parses the header line "p cnf <vars> <clauses>", p points right after 'p'
+static const char* dimacs_header(const char* p, const char* end, DimacsCnf* cnf) {
+  p = skip_blanks(p, end);
+  if (end - p < 3 || strncmp(p, "cnf", 3) != 0) return NULL;
+  if ((p = scan_number(p + 3, end, &cnf->num_vars)) == NULL) return NULL;
+  if ((p = scan_number(p, end, &cnf->num_clauses)) == NULL) return NULL;
+
+  cnf->occurrences = calloc(cnf->num_vars + 1, sizeof(c2dSize));
+  return skip_line(p, end);
+}
+
+// reads a literal of a variable from 1 to max_var, returns NULL if there is none
+static const char* scan_literal(const char* p, const char* end, c2dSize max_var, c2dLiteral* lit) {
+  p = skip_blanks(p, end);
+  BOOLEAN neg = p < end && *p == '-';
+  c2dSize var;
+  if ((p = scan_number(p + neg, end, &var)) == NULL || var == 0 || var > max_var) return NULL;
+  *lit = neg ? -(c2dLiteral)var : (c2dLiteral)var;
+  return p;
+}
+
+#define WEIGHT_MAX_LEN 64
+
+// reads a weight (a decimal number, possibly with an exponent), returns NULL if there is none
+static const char* scan_weight(const char* p, const char* end, double* weight) {
+  p = skip_blanks(p, end);
+  char token[WEIGHT_MAX_LEN];
+  c2dSize len = 0;
+  while (p < end && !is_space(*p)) {
+    if (len + 1 == WEIGHT_MAX_LEN) return NULL;
+    token[len++] = *p++;
+  }
+  token[len] = '\0';
+
+  char* token_end;
+  *weight = strtod(token, &token_end);
+  if (len == 0 || token_end != token + len || *weight != *weight) return NULL;
+  return p;
+}
+
+// returns 1 if the word is at p, followed by a space or the end of the input
+static inline BOOLEAN match_word(const char* p, const char* end, const char* word) {
+  c2dSize len = strlen(word);
+  return (c2dSize)(end - p) >= len && strncmp(p, word, len) == 0 && (p + len == end || is_space(p[len]));
+}
+
+// sets the weight of a literal; with complement, its negation gets 1 - weight, and both
+// get 1 if weight is -1
+static void set_weight(DimacsCnf* cnf, c2dLiteral lit, double weight, BOOLEAN complement) {
+  if (cnf->weights == NULL) {
+    c2dSize num_codes = 2 * (cnf->num_vars + 1);
+    cnf->weights = malloc(sizeof(double) * num_codes);
+    for (c2dSize i = 0; i < num_codes; i++) cnf->weights[i] = 1;
+  }
+
+  c2dLitCode code = lit_code(lit);
+  if (!complement) {
+    cnf->weights[code] = weight;
+  } else if (weight == -1) {
+    cnf->weights[code] = cnf->weights[code_op(code)] = 1;
+  } else {
+    cnf->weights[code] = weight;
+    cnf->weights[code_op(code)] = 1 - weight;
+  }
+}
+
+// parses a weight line, p points right after "w" or "c p weight"; a positive literal of a
+// "w" line (cachet format) also gives the weight of its negation
+static const char* dimacs_weight(DimacsParser* parser, const char* p, const char* end, BOOLEAN cachet) {
+  DimacsCnf* cnf = parser->cnf;
+  BOOLEAN header = cnf->occurrences != NULL;
+  c2dLiteral lit;
+  double weight;
+  if ((p = scan_literal(p, end, header ? cnf->num_vars : (c2dSize)LONG_MAX, &lit)) == NULL) return NULL;
+  if ((p = scan_weight(p, end, &weight)) == NULL) return NULL;
+  parser->weighted = 1;
+
+  if (header) {
+    set_weight(cnf, lit, weight, cachet && lit > 0);
+  } else {
+    if (parser->num_early_weights == parser->early_weights_cap) {
+      parser->early_weights_cap = parser->early_weights_cap == 0 ? 16 : 2 * parser->early_weights_cap;
+      parser->early_weights = realloc(parser->early_weights, sizeof(EarlyWeight) * parser->early_weights_cap);
+    }
+    EarlyWeight* early = &(parser->early_weights[parser->num_early_weights++]);
+    early->lit = lit;
+    early->weight = weight;
+    early->complement = cachet && lit > 0;
+  }
+  return skip_line(p, end);
+}
+
+// sets the weights read before the header, returns 0 if one of them is not a literal of the cnf
+static BOOLEAN set_early_weights(DimacsParser* parser) {
+  DimacsCnf* cnf = parser->cnf;
+  for (c2dSize i = 0; i < parser->num_early_weights; i++) {
+    const EarlyWeight* early = &(parser->early_weights[i]);
+    if ((c2dSize)labs(early->lit) > cnf->num_vars) return 0;
+    set_weight(cnf, early->lit, early->weight, early->complement);
+  }
+  parser->num_early_weights = 0;
+  return 1;
+}
+
+// parses a comment line, p points right after 'c': "c p weight" lines give weights, and
+// "c t wmc" lines announce them
+static const char* dimacs_comment(DimacsParser* parser, const char* p, const char* end) {
+  p = skip_blanks(p, end);
+  if (match_word(p, end, "p")) {
+    const char* q = skip_blanks(p + 1, end);
+    if (match_word(q, end, "weight")) return dimacs_weight(parser, q + 6, end, 0);
+  } else if (match_word(p, end, "t")) {
+    const char* q = skip_blanks(p + 1, end);
+    if (match_word(q, end, "wmc") || match_word(q, end, "pwmc")) parser->weighted = 1;
+  }
+  return skip_line(p, end);
+}
+
+static void dimacs_parser_init(DimacsParser* parser) {
+  DimacsCnf* cnf = malloc(sizeof(DimacsCnf));
+  cnf->num_vars = 0;
+  cnf->num_clauses = 0;
+  cnf->occurrences = NULL;
+  cnf->weights = NULL;
+  cnf->num_codes = 0;
+  cnf->codes_cap = 1024;
+  cnf->codes = malloc(sizeof(c2dLitCode) * cnf->codes_cap);
+  cnf->parse_time = 0;
+
+  parser->cnf = cnf;
+  parser->clause_count = 0;
+  parser->clause_size = 0;
+  parser->done = 0;
+  parser->finished = 0;
+  parser->weighted = 0;
+  parser->error = 0;
+  parser->early_weights = NULL;
+  parser->num_early_weights = 0;
+  parser->early_weights_cap = 0;
+}
+
+// scans the bytes [p, end), which must not end in the middle of a line
+// unless it is the last line of the input
+static void dimacs_parse_chunk(DimacsParser* parser, const char* p, const char* end) {
+  DimacsCnf* cnf = parser->cnf;
+  c2dSize clause_size = parser->clause_size;
+
+  while (p < end) {
+    char c = *p;
+    if (is_space(c)) {
+      ++p;
+    } else if (c == 'c') {
+      if ((p = dimacs_comment(parser, p + 1, end)) == NULL) break;
+    } else if (c == 'w') {
+      if ((p = dimacs_weight(parser, p + 1, end, 1)) == NULL) break;
+    } else if (parser->done) {
+      parser->finished = 1;
+      break;
+    } else if (c == 'p' && cnf->occurrences == NULL) {
+      if ((p = dimacs_header(p + 1, end, cnf)) == NULL || !set_early_weights(parser)) {
+        p = NULL;
+        break;
+      }
+    } else if (c == '%') {
+      parser->done = 1;
+      parser->finished = 1;
+      break;
+    } else {
+      BOOLEAN neg = (c == '-');
+      if (neg) ++p;
+      if (cnf->occurrences == NULL || p == end || !is_digit(*p)) {
+        p = NULL;
+        break;
+      }
+      c2dSize var = 0;
+      while (p < end && is_digit(*p)) var = var * 10 + (c2dSize)(*p++ - '0');
+      if (var > cnf->num_vars) {
+        p = NULL;
+        break;
+      }
+
+      if (var == 0) {
+        // empty clauses are skipped
+        if (clause_size > 0) {
+          dimacs_push(cnf, 0);
+          clause_size = 0;
+          if (++parser->clause_count == cnf->num_clauses) parser->done = 1;
+        }
+      } else {
+        dimacs_push(cnf, neg ? (c2dLitCode)(2 * var + 1) : (c2dLitCode)(2 * var));
+        ++cnf->occurrences[var];
+        ++clause_size;
+      }
+    }
+  }
+
+  parser->clause_size = clause_size;
+  if (p == NULL) parser->error = 1;
+}
+
+// returns the parsed cnf, or NULL if the input was not a valid cnf
+static DimacsCnf* dimacs_parser_finish(DimacsParser* parser) {
+  DimacsCnf* cnf = parser->cnf;
+  free(parser->early_weights);
+
+  // the last clause may miss its terminating 0
+  if (!parser->done && parser->clause_size > 0) {
+    dimacs_push(cnf, 0);
+    ++parser->clause_count;
+  }
+  if (parser->error || cnf->occurrences == NULL) {
+    dimacs_free(cnf);
+    return NULL;
+  }
+  cnf->num_clauses = parser->clause_count;
+  return cnf;
+}
+
+//parses a cnf in DIMACS format from a buffer of len bytes
+//returns NULL if the buffer is not a valid cnf
+DimacsCnf* dimacs_parse(const char* buf, c2dSize len) {
+  double start = sat_clock();
+  SAT_TRACE_BEGIN(TRACE_PARSE);
+  DimacsParser parser;
+  dimacs_parser_init(&parser);
+  dimacs_parse_chunk(&parser, buf, buf + len);
+
+  DimacsCnf* cnf = dimacs_parser_finish(&parser);
+  SAT_TRACE_END(TRACE_PARSE);
+  if (cnf != NULL) cnf->parse_time = sat_clock() - start;
+  return cnf;
+}
+
+/******************************************************************************
+ * Streams
+ ******************************************************************************/
+
+typedef c2dSize (*read_function)(void* source, char* buf, c2dSize len);
+
+static c2dSize read_fd(void* source, char* buf, c2dSize len) {
+  ssize_t n;
+  do {
+    n = read(*(int*)source, buf, len);
+  } while (n < 0 && errno == EINTR);
+  return n > 0 ? (c2dSize)n : 0;
+}
+
+static c2dSize read_file(void* source, char* buf, c2dSize len) {
+  return fread(buf, 1, len, (FILE*)source);
+}
+
+// parses everything read from the source; the first prefix_len bytes of the input
+// have been read already and are given in prefix
+// *complete is set when all the clauses were read, possibly before the end of the input
+static DimacsCnf* dimacs_parse_stream(read_function read_source, void* source,
+                                      const char* prefix, c2dSize prefix_len, BOOLEAN* complete) {
+  double start = sat_clock();
+  SAT_TRACE_BEGIN(TRACE_PARSE);
+  DimacsParser parser;
+  dimacs_parser_init(&parser);
+
+  c2dSize cap = STREAM_CHUNK;
+  c2dSize len = prefix_len;
+  char* buf = malloc(cap);
+  if (prefix_len > 0) memcpy(buf, prefix, prefix_len);
+
+  BOOLEAN eof = 0;
+  // an input without weights is read up to its last clause
+  while (!eof && !parser.finished && !parser.error && !(parser.done && !parser.weighted)) {
+    // a line longer than the buffer makes it grow
+    if (len == cap) {
+      cap *= 2;
+      buf = realloc(buf, cap);
+    }
+    c2dSize n = read_source(source, buf + len, cap - len);
+    if (n == 0) eof = 1;
+    len += n;
+
+    // scans up to the last complete line
+    c2dSize line_end = len;
+    if (!eof) {
+      while (line_end > 0 && buf[line_end - 1] != '\n') --line_end;
+      if (line_end == 0) continue;
+    }
+    dimacs_parse_chunk(&parser, buf, buf + line_end);
+    memmove(buf, buf + line_end, len - line_end);
+    len -= line_end;
+  }
+  free(buf);
+  *complete = parser.done;
+
+  DimacsCnf* cnf = dimacs_parser_finish(&parser);
+  SAT_TRACE_END(TRACE_PARSE);
+  if (cnf != NULL) cnf->parse_time = sat_clock() - start;
+  return cnf;
+}
+
+/******************************************************************************
+ * Compressed input
+ *
+ * gzip, xz and bzip2 input is recognized by its magic bytes (or, failing that,
+ * by the file extension) and decompressed by the corresponding tool running in
+ * a child process, whose output is parsed while it is produced. Nothing is
+ * written to disk.
+ ******************************************************************************/
+
+#define MAGIC_LEN 6
+
+// returns the command decompressing the input, NULL if the input is not compressed
+static const char* decompressor(const unsigned char* magic, c2dSize len, const char* file_name) {
+  if (len >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return "gzip";
+  if (len >= 6 && memcmp(magic, "\xfd" "7zXZ\0", 6) == 0) return "xz";
+  if (len >= 3 && memcmp(magic, "BZh", 3) == 0) return "bzip2";
+
+  const char* ext = file_name == NULL ? NULL : strrchr(file_name, '.');
+  if (ext == NULL) return NULL;
+  if (strcmp(ext, ".gz") == 0) return "gzip";
+  if (strcmp(ext, ".xz") == 0 || strcmp(ext, ".lzma") == 0) return "xz";
+  if (strcmp(ext, ".bz2") == 0) return "bzip2";
+  return NULL;
+}
+
+static BOOLEAN write_all(int fd, const char* buf, c2dSize len) {
+  while (len > 0) {
+    ssize_t n = write(fd, buf, len);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return 0;
+    buf += n;
+    len -= (c2dSize)n;
+  }
+  return 1;
+}
+
+// starts the decompressor, reading from in_fd when it is given (>= 0); otherwise a
+// second child feeds it the prefix and then the rest of the source
+// returns the pid of the decompressor and sets *out_fd to its output, -1 on failure
+static pid_t spawn_decompressor(const char* command, int in_fd, read_function read_source,
+                                void* source, const char* prefix, c2dSize prefix_len,
+                                int* out_fd, pid_t* feeder) {
+  int out_pipe[2], in_pipe[2] = {-1, -1};
+  if (pipe(out_pipe) != 0) return -1;
+  if (in_fd < 0 && pipe(in_pipe) != 0) {
+    close(out_pipe[0]);
+    close(out_pipe[1]);
+    return -1;
+  }
+
+  fflush(NULL);
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(in_fd >= 0 ? in_fd : in_pipe[0], STDIN_FILENO);
+    dup2(out_pipe[1], STDOUT_FILENO);
+    close(out_pipe[0]);
+    close(out_pipe[1]);
+    if (in_fd < 0) close(in_pipe[0]), close(in_pipe[1]);
+    execlp(command, command, "-dc", (char*)NULL);
+    _exit(127);
+  }
+  close(out_pipe[1]);
+
+  *feeder = -1;
+  if (in_fd < 0) {
+    close(in_pipe[0]);
+    if (pid > 0) *feeder = fork();
+    if (*feeder == 0) {
+      close(out_pipe[0]);
+      char* buf = malloc(STREAM_CHUNK);
+      BOOLEAN ok = write_all(in_pipe[1], prefix, prefix_len);
+      c2dSize n;
+      while (ok && (n = read_source(source, buf, STREAM_CHUNK)) > 0) ok = write_all(in_pipe[1], buf, n);
+      _exit(ok ? 0 : 1);
+    }
+    close(in_pipe[1]);
+  }
+
+  if (pid < 0) {
+    close(out_pipe[0]);
+    return -1;
+  }
+  *out_fd = out_pipe[0];
+  return pid;
+}
+
+// parses a possibly compressed input; in_fd is the source itself when it can be
+// handed to the decompressor directly (-1 otherwise)
+static DimacsCnf* dimacs_read_source(read_function read_source, void* source, int in_fd,
+                                     const char* file_name) {
+  // a seekable descriptor is given to the decompressor as it is, after rewinding it
+  off_t origin = in_fd >= 0 ? lseek(in_fd, 0, SEEK_CUR) : -1;
+  if (origin < 0) in_fd = -1;
+
+  BOOLEAN complete;
+  unsigned char magic[MAGIC_LEN];
+  c2dSize magic_len = 0, n;
+  while (magic_len < MAGIC_LEN && (n = read_source(source, (char*)magic + magic_len, MAGIC_LEN - magic_len)) > 0) {
+    magic_len += n;
+  }
+
+  const char* command = decompressor(magic, magic_len, file_name);
+  if (command == NULL) return dimacs_parse_stream(read_source, source, (char*)magic, magic_len, &complete);
+  if (in_fd >= 0 && lseek(in_fd, origin, SEEK_SET) != origin) return NULL;
+
+  int out_fd;
+  pid_t feeder;
+  pid_t pid = spawn_decompressor(command, in_fd, read_source, source, (char*)magic, magic_len,
+                                 &out_fd, &feeder);
+  if (pid < 0) return NULL;
+
+  DimacsCnf* cnf = dimacs_parse_stream(read_fd, &out_fd, NULL, 0, &complete);
+
+  // the children may still be writing if all clauses were read before the end,
+  // otherwise the decompressor must have succeeded
+  close(out_fd);
+  int status;
+  waitpid(pid, &status, 0);
+  if (feeder > 0) waitpid(feeder, NULL, 0);
+  BOOLEAN ok = (WIFEXITED(status) && WEXITSTATUS(status) == 0) ||
+               (WIFSIGNALED(status) && WTERMSIG(status) == SIGPIPE);
+  if (cnf != NULL && !complete && !ok) {
+    dimacs_free(cnf);
+    cnf = NULL;
+  }
+  return cnf;
+}
+
+//reads a cnf in DIMACS format from a file, which is mapped into memory unless it is compressed
+//returns NULL if the file cannot be read or is not a valid cnf
+DimacsCnf* dimacs_read_file(const char* file_name) {
+  double start = sat_clock();
+  int fd = open(file_name, O_RDONLY);
+  if (fd < 0) return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+
+  unsigned char magic[MAGIC_LEN];
+  ssize_t magic_len = pread(fd, magic, MAGIC_LEN, 0);
+  c2dSize len = (c2dSize)st.st_size;
+
+  DimacsCnf* cnf;
+  if (!S_ISREG(st.st_mode) || decompressor(magic, magic_len < 0 ? 0 : magic_len, file_name) != NULL) {
+    cnf = dimacs_read_source(read_fd, &fd, fd, file_name);
+  } else if (len == 0) {
+    cnf = dimacs_parse("", 0);
+  } else {
+    char* buf = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (buf == MAP_FAILED) {
+      close(fd);
+      return NULL;
+    }
+    posix_madvise(buf, len, POSIX_MADV_SEQUENTIAL);
+    cnf = dimacs_parse(buf, len);
+    munmap(buf, len);
+  }
+  close(fd);
+
+  if (cnf != NULL) cnf->parse_time = sat_clock() - start;
+  return cnf;
+}
+
+//reads a cnf in DIMACS format from an open file descriptor, e.g. a pipe
+//the descriptor is read up to the last clause and is not closed
+DimacsCnf* dimacs_read_fd(int fd) {
+  double start = sat_clock();
+  DimacsCnf* cnf = dimacs_read_source(read_fd, &fd, fd, NULL);
+  if (cnf != NULL) cnf->parse_time = sat_clock() - start;
+  return cnf;
+}
+
+//reads a cnf in DIMACS format from a stream, which is not closed
+DimacsCnf* dimacs_read_stream(FILE* file) {
+  double start = sat_clock();
+  DimacsCnf* cnf = dimacs_read_source(read_file, file, -1, NULL);
+  if (cnf != NULL) cnf->parse_time = sat_clock() - start;
+  return cnf;
+}
+
+void dimacs_free(DimacsCnf* cnf) {
+  free(cnf->occurrences);
+  free(cnf->weights);
+  free(cnf->codes);
+  free(cnf);
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,112 @@
+#include <pthread.h>
+#include "sat_api.h"
+
+/******************************************************************************
+ * Portfolio
+ *
+ * Each worker builds its own sat state from the shared parsed cnf (which is only
+ * read, so no lock is needed) and runs sat_solve() in its own thread. The sat
+ * states have no shared scratch buffers, nor any global state, so the searches
+ * are independent.
+ *
+ * The workers are diversified by their settings: worker 0 runs the defaults,
+ * the others get their own seed, and alternate restart policies, preprocessing,
+ * probing and reduction schedules. The first worker with an answer records it
+ * and sets the stop flag, which makes the other searches return SAT_UNKNOWN.
+ *
+ * The workers share their short learned clauses through a clause exchange, and
+ * pick up the clauses of the others after their restarts.
+ ******************************************************************************/
+
+#define SHARE_MAX_LBD 4   // learned clauses shared between the workers
+#define SHARE_MAX_SIZE 8
+
+typedef struct portfolio {
+  const DimacsCnf* cnf;
+  ClauseExchange* exchange;
+  double seconds;
+  volatile BOOLEAN stop;   // set by the first worker with an answer
+  pthread_mutex_t lock;    // protects result and model
+  int result;
+  BOOLEAN* model;
+} Portfolio;
+
+typedef struct portfolio_worker {
+  Portfolio* portfolio;
+  c2dSize id;
+  pthread_t thread;
+} PortfolioWorker;
+
+// applies the settings of worker id to a new sat state
+static void diversify(SatState* sat_state, c2dSize id) {
+  if (id == 0) return;
+  sat_set_seed(sat_state, id);
+  if (id % 2 == 1) sat_set_restart_policy(sat_state, RESTART_LUBY);
+  if (id % 4 == 3) sat_set_probe_schedule(sat_state, 0, 0);
+  if (id % 4 == 2) sat_set_reduce_schedule(sat_state, 4000, 600);
+}
+
+static void* portfolio_worker_run(void* arg) {
+  PortfolioWorker* worker = arg;
+  Portfolio* portfolio = worker->portfolio;
+
+  SatState* sat_state = sat_state_new_from_cnf(portfolio->cnf);
+  sat_set_interrupt(sat_state, &(portfolio->stop));
+  sat_set_clause_exchange(sat_state, portfolio->exchange, worker->id);
+  sat_set_solve_limits(sat_state, 0, 0, portfolio->seconds);
+  if (worker->id % 2 == 0) sat_preprocess(sat_state);
+  diversify(sat_state, worker->id);
+
+  int result = sat_solve(sat_state);
+  if (result != SAT_UNKNOWN) {
+    pthread_mutex_lock(&(portfolio->lock));
+    if (portfolio->result == SAT_UNKNOWN) {
+      portfolio->result = result;
+      if (result == SAT_SATISFIABLE && portfolio->model != NULL) {
+        memcpy(portfolio->model, sat_model(sat_state), sizeof(BOOLEAN) * (portfolio->cnf->num_vars + 1));
+      }
+      __atomic_store_n(&(portfolio->stop), 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&(portfolio->lock));
+  }
+
+  sat_state_free(sat_state);
+  return NULL;
+}
+
+//decides the satisfiability of cnf with num_threads parallel searches, within seconds (0 for
+//no limit); on SAT_SATISFIABLE, model (num_vars + 1 entries) receives the model by variable
+//index, 1 if true and -1 if false
+//returns SAT_SATISFIABLE, SAT_UNSATISFIABLE, or SAT_UNKNOWN when the time runs out
+int sat_portfolio_solve(const DimacsCnf* cnf, c2dSize num_threads, double seconds, BOOLEAN* model) {
+  if (num_threads == 0) num_threads = 1;
+  Portfolio portfolio;
+  portfolio.cnf = cnf;
+  portfolio.exchange = clause_exchange_new(num_threads, SHARE_MAX_LBD, SHARE_MAX_SIZE);
+  portfolio.seconds = seconds;
+  portfolio.stop = 0;
+  pthread_mutex_init(&(portfolio.lock), NULL);
+  portfolio.result = SAT_UNKNOWN;
+  portfolio.model = model;
+
+  PortfolioWorker* workers = malloc(sizeof(PortfolioWorker) * num_threads);
+  c2dSize num_started = 0;
+  for (c2dSize i = 0; i < num_threads; i++) {
+    workers[i].portfolio = &portfolio;
+    workers[i].id = i;
+    if (pthread_create(&(workers[i].thread), NULL, portfolio_worker_run, &(workers[i])) != 0) break;
+    ++num_started;
+  }
+  // Runs in the calling thread if no thread could be started
+  if (num_started == 0) portfolio_worker_run(&(workers[0]));
+  for (c2dSize i = 0; i < num_started; i++) pthread_join(workers[i].thread, NULL);
+
+  free(workers);
+  clause_exchange_free(portfolio.exchange);
+  pthread_mutex_destroy(&(portfolio.lock));
+  return portfolio.result;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
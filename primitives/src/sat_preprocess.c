@@ -0,0 +1,642 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Preprocessing
+ *
+ * The cnf clauses are copied into a working set with full occurrence lists,
+ * simplified, and handed back to the sat state. In order:
+ * --units are propagated, removing satisfied clauses and false literals
+ * --equivalent literals (strongly connected components of the binary implication
+ * graph) are replaced by one representative
+ * --clauses subsumed by another clause are removed, and clauses which resolve with
+ * another one into a subset of themselves are strengthened
+ * --a variable is eliminated by replacing the clauses mentioning it with their
+ * resolvents, when this does not increase the number of clauses
+ *
+ * The clauses removed together with an eliminated (or substituted) variable are
+ * pushed on a stack, each one with the literal of the variable in front. Going
+ * down the stack, a clause which is false in the model gets its first literal
+ * set, which gives the eliminated variables values satisfying the original cnf.
+ ******************************************************************************/
+
+#define PREPROCESS_STEPS 100000000 // literals visited by subsumption and elimination, at most
+#define ELIM_OCCURRENCES 16        // variables with more occurrences of both signs are kept
+#define ELIM_RESOLVENT_SIZE 24     // and so are variables producing longer resolvents
+#define LITS_BLOCK ((c2dSize)1 << 20) // literals per block of clause memory
+
+typedef struct pp_clause {
+  c2dLitCode* lits;
+  c2dSize size;
+  unsigned long signature;  // a bit per variable (modulo the number of bits)
+  BOOLEAN removed;
+} PpClause;
+
+typedef struct pp_list {
+  c2dSize size;
+  c2dSize cap;
+  c2dSize* items;
+} PpList;
+
+typedef struct preprocessor {
+  c2dSize num_vars;
+
+  PpClause* clauses;
+  c2dSize num_clauses;
+  c2dSize clauses_cap;
+  PpList* occs;         // by literal code, the clauses containing the literal
+  c2dLitCode** blocks;  // memory of the literals of the clauses, released all at once
+  c2dSize num_blocks;
+  c2dSize block_used;   // literals used in the last block
+
+  BOOLEAN* values;      // by literal code, the assignment implied by the units
+  c2dLitCode* units;    // assigned literals, units[units_head..num_units) not propagated yet
+  c2dSize num_units;
+  c2dSize units_head;
+
+  BOOLEAN* marks;       // by literal code, all 0 between two uses
+  c2dLitCode* buf;      // scratch clause
+  c2dSize buf_cap;
+
+  c2dLitCode* stack;    // reconstruction stack, handed to the sat state in the end
+  c2dSize stack_size;
+  c2dSize stack_cap;
+  BOOLEAN* eliminated;  // the array of the sat state
+  c2dSize num_eliminated;
+
+  c2dSize steps;
+  BOOLEAN unsat;
+} Preprocessor;
+
+static void list_push(PpList* list, c2dSize item) {
+  if (list->size == list->cap) {
+    list->cap = list->cap < 4 ? 4 : 2 * list->cap;
+    list->items = realloc(list->items, sizeof(c2dSize) * list->cap);
+  }
+  list->items[list->size++] = item;
+}
+
+static void list_remove(PpList* list, c2dSize item) {
+  for (c2dSize i = 0; i < list->size; i++) {
+    if (list->items[i] == item) {
+      list->items[i] = list->items[--list->size];
+      return;
+    }
+  }
+}
+
+// returns room for size literals, which stays in place until the preprocessor is freed
+static c2dLitCode* alloc_lits(Preprocessor* pp, c2dSize size) {
+  if (pp->num_blocks == 0 || pp->block_used + size > LITS_BLOCK) {
+    pp->blocks = realloc(pp->blocks, sizeof(c2dLitCode*) * (pp->num_blocks + 1));
+    pp->blocks[pp->num_blocks++] = malloc(sizeof(c2dLitCode) * (size > LITS_BLOCK ? size : LITS_BLOCK));
+    pp->block_used = 0;
+  }
+  c2dLitCode* lits = pp->blocks[pp->num_blocks - 1] + pp->block_used;
+  pp->block_used += size;
+  return lits;
+}
+
+static void ensure_buf(Preprocessor* pp, c2dSize size) {
+  if (size > pp->buf_cap) {
+    while (size > pp->buf_cap) pp->buf_cap *= 2;
+    pp->buf = realloc(pp->buf, sizeof(c2dLitCode) * pp->buf_cap);
+  }
+}
+
+/******************************************************************************
+ * Clauses and units
+ ******************************************************************************/
+
+static void assign(Preprocessor* pp, c2dLitCode lit) {
+  if (pp->values[lit] > 0) return;
+  if (pp->values[lit] < 0) {
+    pp->unsat = 1;
+    return;
+  }
+  pp->values[lit] = 1;
+  pp->values[code_op(lit)] = -1;
+  pp->units[pp->num_units++] = lit;
+}
+
+static inline unsigned long signature(const c2dLitCode* lits, c2dSize size) {
+  unsigned long sig = 0;
+  for (c2dSize i = 0; i < size; i++) sig |= 1UL << (code_var(lits[i]) % (8 * sizeof(unsigned long)));
+  return sig;
+}
+
+static int compare_codes(const void* a, const void* b) {
+  c2dLitCode x = *(const c2dLitCode*)a, y = *(const c2dLitCode*)b;
+  return x < y ? -1 : x > y;
+}
+
+// sorts the literals, drops the duplicate and false ones, and adds the clause unless it
+// is satisfied or a tautology; units are assigned instead of being added
+static void add_clause(Preprocessor* pp, c2dLitCode* lits, c2dSize size) {
+  if (size > 16) {
+    qsort(lits, size, sizeof(c2dLitCode), compare_codes);
+  } else {
+    for (c2dSize i = 1; i < size; i++) {
+      c2dLitCode lit = lits[i];
+      c2dSize k = i;
+      for (; k > 0 && lits[k - 1] > lit; k--) lits[k] = lits[k - 1];
+      lits[k] = lit;
+    }
+  }
+  c2dSize j = 0;
+  for (c2dSize i = 0; i < size; i++) {
+    c2dLitCode lit = lits[i];
+    if (pp->values[lit] > 0) return;
+    if (pp->values[lit] < 0 || (j > 0 && lits[j - 1] == lit)) continue;
+    if (j > 0 && lits[j - 1] == code_op(lit)) return;  // the signs of a variable are adjacent
+    lits[j++] = lit;
+  }
+
+  if (j == 0) {
+    pp->unsat = 1;
+  } else if (j == 1) {
+    assign(pp, lits[0]);
+  } else {
+    if (pp->num_clauses == pp->clauses_cap) {
+      pp->clauses_cap *= 2;
+      pp->clauses = realloc(pp->clauses, sizeof(PpClause) * pp->clauses_cap);
+    }
+    PpClause* clause = &(pp->clauses[pp->num_clauses]);
+    clause->lits = alloc_lits(pp, j);
+    memcpy(clause->lits, lits, sizeof(c2dLitCode) * j);
+    clause->size = j;
+    clause->signature = signature(lits, j);
+    clause->removed = 0;
+    for (c2dSize i = 0; i < j; i++) list_push(&(pp->occs[lits[i]]), pp->num_clauses);
+    ++pp->num_clauses;
+  }
+}
+
+static void remove_clause(Preprocessor* pp, c2dSize id) {
+  PpClause* clause = &(pp->clauses[id]);
+  for (c2dSize i = 0; i < clause->size; i++) list_remove(&(pp->occs[clause->lits[i]]), id);
+  clause->removed = 1;
+}
+
+// removes lit from the clause; a clause left with one literal becomes a unit
+static void strengthen(Preprocessor* pp, c2dSize id, c2dLitCode lit) {
+  PpClause* clause = &(pp->clauses[id]);
+  for (c2dSize i = 0; i < clause->size; i++) {
+    if (clause->lits[i] == lit) {
+      clause->lits[i] = clause->lits[--clause->size];
+      break;
+    }
+  }
+  list_remove(&(pp->occs[lit]), id);
+  clause->signature = signature(clause->lits, clause->size);
+  if (clause->size == 1) {
+    assign(pp, clause->lits[0]);
+    remove_clause(pp, id);
+  }
+}
+
+static void propagate_units(Preprocessor* pp) {
+  while (pp->units_head < pp->num_units && !pp->unsat) {
+    c2dLitCode lit = pp->units[pp->units_head++];
+    PpList* satisfied = &(pp->occs[lit]);
+    while (satisfied->size > 0) remove_clause(pp, satisfied->items[0]);
+    PpList* falsified = &(pp->occs[code_op(lit)]);
+    while (falsified->size > 0 && !pp->unsat) strengthen(pp, falsified->items[0], code_op(lit));
+  }
+}
+
+// pushes a clause on the reconstruction stack: the witness, the other literals, and the size
+static void push_reconstruction(Preprocessor* pp, const c2dLitCode* lits, c2dSize size, c2dLitCode witness) {
+  if (pp->stack_size + size + 1 > pp->stack_cap) {
+    while (pp->stack_size + size + 1 > pp->stack_cap) pp->stack_cap = pp->stack_cap < 64 ? 64 : 2 * pp->stack_cap;
+    pp->stack = realloc(pp->stack, sizeof(c2dLitCode) * pp->stack_cap);
+  }
+  pp->stack[pp->stack_size++] = witness;
+  for (c2dSize i = 0; i < size; i++) {
+    if (lits[i] != witness) pp->stack[pp->stack_size++] = lits[i];
+  }
+  pp->stack[pp->stack_size++] = (c2dLitCode)size;
+}
+
+/******************************************************************************
+ * Equivalent literals
+ ******************************************************************************/
+
+// returns the literal implied by lit through the i^th clause containing code_op(lit), 0 if
+// that clause is not binary; these are the successors of lit in the implication graph
+static inline c2dLitCode implied_literal(const Preprocessor* pp, c2dLitCode lit, c2dSize i) {
+  const PpClause* clause = &(pp->clauses[pp->occs[code_op(lit)].items[i]]);
+  if (clause->size != 2) return 0;
+  return clause->lits[0] == code_op(lit) ? clause->lits[1] : clause->lits[0];
+}
+
+static void substitute_equivalences(Preprocessor* pp) {
+  c2dSize num_codes = 2 * (pp->num_vars + 1);
+  c2dSize* order = calloc(num_codes, sizeof(c2dSize));  // dfs number, 0 if not visited
+  c2dSize* low = malloc(sizeof(c2dSize) * num_codes);
+  c2dLitCode* repr = malloc(sizeof(c2dLitCode) * num_codes);
+  c2dLitCode* scc = malloc(sizeof(c2dLitCode) * num_codes);
+  c2dLitCode* path = malloc(sizeof(c2dLitCode) * num_codes);
+  c2dSize* next = malloc(sizeof(c2dSize) * num_codes);  // next successor to visit, by path entry
+  BOOLEAN* on_scc = calloc(num_codes, sizeof(BOOLEAN));
+  c2dSize count = 0, scc_size = 0;
+  BOOLEAN found = 0;
+
+  for (c2dLitCode i = 0; i < num_codes; i++) repr[i] = i;
+
+  // Tarjan's algorithm, with an explicit path instead of recursion
+  for (c2dLitCode root = 2; root < num_codes; root++) {
+    if (order[root] != 0 || pp->values[root] != 0 || pp->eliminated[code_var(root)]) continue;
+    c2dSize depth = 0;
+    path[depth] = root;
+    next[depth++] = 0;
+    order[root] = low[root] = ++count;
+    scc[scc_size++] = root;
+    on_scc[root] = 1;
+
+    while (depth > 0) {
+      c2dLitCode lit = path[depth - 1];
+      if (next[depth - 1] < pp->occs[code_op(lit)].size) {
+        c2dLitCode succ = implied_literal(pp, lit, next[depth - 1]++);
+        if (succ == 0 || pp->values[succ] != 0) continue;
+        if (order[succ] == 0) {
+          order[succ] = low[succ] = ++count;
+          scc[scc_size++] = succ;
+          on_scc[succ] = 1;
+          path[depth] = succ;
+          next[depth++] = 0;
+        } else if (on_scc[succ] && order[succ] < low[lit]) {
+          low[lit] = order[succ];
+        }
+        continue;
+      }
+
+      if (low[lit] == order[lit]) {
+        // the component is popped, its smallest literal becomes the representative
+        c2dSize start = scc_size;
+        c2dLitCode min = lit;
+        do {
+          --start;
+          on_scc[scc[start]] = 0;
+          if (scc[start] < min) min = scc[start];
+        } while (scc[start] != lit);
+        for (c2dSize i = start; i < scc_size; i++) {
+          repr[scc[i]] = min;
+          if (repr[code_op(scc[i])] == min) pp->unsat = 1;  // lit and its negation are equivalent
+        }
+        if (scc_size - start > 1) found = 1;
+        scc_size = start;
+      }
+      if (--depth > 0 && low[lit] < low[path[depth - 1]]) low[path[depth - 1]] = low[lit];
+    }
+  }
+
+  if (found && !pp->unsat) {
+    // The components of a literal and of its negation mirror each other, so both signs of a
+    // variable agree on the representative variable
+    for (c2dSize var = 1; var <= pp->num_vars; var++) {
+      c2dLitCode lit = 2 * var;
+      if (repr[lit] == lit) continue;
+      c2dLitCode clause[2] = {lit, code_op(repr[lit])};
+      push_reconstruction(pp, clause, 2, lit);
+      clause[0] = code_op(lit), clause[1] = repr[lit];
+      push_reconstruction(pp, clause, 2, code_op(lit));
+      pp->eliminated[var] = 1;
+      ++pp->num_eliminated;
+    }
+
+    // Every clause is added again with the literals replaced by their representatives
+    c2dSize num_clauses = pp->num_clauses;
+    for (c2dSize id = 0; id < num_clauses && !pp->unsat; id++) {
+      PpClause* clause = &(pp->clauses[id]);
+      if (clause->removed) continue;
+      BOOLEAN changed = 0;
+      for (c2dSize i = 0; i < clause->size; i++) changed |= (repr[clause->lits[i]] != clause->lits[i]);
+      if (!changed) continue;
+
+      ensure_buf(pp, clause->size);
+      c2dSize size = clause->size;
+      for (c2dSize i = 0; i < size; i++) pp->buf[i] = repr[clause->lits[i]];
+      remove_clause(pp, id);
+      add_clause(pp, pp->buf, size);
+    }
+    propagate_units(pp);
+  }
+
+  free(order);
+  free(low);
+  free(repr);
+  free(scc);
+  free(path);
+  free(next);
+  free(on_scc);
+}
+
+/******************************************************************************
+ * Subsumption and self-subsuming resolution
+ ******************************************************************************/
+
+// returns the clause indices sorted by size, shortest first
+static c2dSize* clauses_by_size(const Preprocessor* pp) {
+  c2dSize max_size = 0;
+  for (c2dSize id = 0; id < pp->num_clauses; id++) {
+    if (!pp->clauses[id].removed && pp->clauses[id].size > max_size) max_size = pp->clauses[id].size;
+  }
+  c2dSize* start = calloc(max_size + 2, sizeof(c2dSize));
+  for (c2dSize id = 0; id < pp->num_clauses; id++) {
+    if (!pp->clauses[id].removed) ++start[pp->clauses[id].size + 1];
+  }
+  for (c2dSize s = 1; s <= max_size + 1; s++) start[s] += start[s - 1];
+  c2dSize* ids = malloc(sizeof(c2dSize) * (pp->num_clauses + 1));
+  for (c2dSize id = 0; id < pp->num_clauses; id++) {
+    if (!pp->clauses[id].removed) ids[start[pp->clauses[id].size]++] = id;
+  }
+  ids[start[max_size]] = (c2dSize)-1;  // end marker
+  free(start);
+  return ids;
+}
+
+// removes the clauses subsumed by the clause, and strengthens the ones containing all of
+// its literals but one, which they contain negated
+static void backward_subsume(Preprocessor* pp, c2dSize id) {
+  PpClause* clause = &(pp->clauses[id]);
+  c2dSize var = code_var(clause->lits[0]);
+  for (c2dSize i = 0; i < clause->size; i++) {
+    c2dSize v = code_var(clause->lits[i]);
+    if (pp->occs[2 * v].size + pp->occs[2 * v + 1].size < pp->occs[2 * var].size + pp->occs[2 * var + 1].size) var = v;
+    pp->marks[clause->lits[i]] = 1;
+  }
+
+  for (c2dLitCode lit = 2 * var; lit <= 2 * var + 1 && !pp->unsat; lit++) {
+    PpList* occs = &(pp->occs[lit]);
+    for (c2dSize j = 0; j < occs->size && !pp->unsat;) {
+      c2dSize other = occs->items[j];
+      PpClause* d = &(pp->clauses[other]);
+      // the variables of the clause must all be in the other one
+      if (other == id || d->size < clause->size || (clause->signature & ~d->signature) != 0) {
+        ++j;
+        continue;
+      }
+      c2dSize same = 0, negated = 0;
+      c2dLitCode flipped = 0;
+      for (c2dSize k = 0; k < d->size; k++) {
+        if (pp->marks[d->lits[k]]) ++same;
+        else if (pp->marks[code_op(d->lits[k])]) ++negated, flipped = d->lits[k];
+      }
+      pp->steps += d->size;
+
+      if (same == clause->size) remove_clause(pp, other);
+      else if (same + 1 == clause->size && negated == 1) strengthen(pp, other, flipped);
+      if (j < occs->size && occs->items[j] == other) ++j;
+    }
+  }
+
+  for (c2dSize i = 0; i < clause->size; i++) pp->marks[clause->lits[i]] = 0;
+}
+
+static void subsume(Preprocessor* pp) {
+  c2dSize* ids = clauses_by_size(pp);
+  for (c2dSize i = 0; ids[i] != (c2dSize)-1 && !pp->unsat && pp->steps < PREPROCESS_STEPS; i++) {
+    if (!pp->clauses[ids[i]].removed) backward_subsume(pp, ids[i]);
+  }
+  free(ids);
+  propagate_units(pp);
+}
+
+/******************************************************************************
+ * Bounded variable elimination
+ ******************************************************************************/
+
+// writes the resolvent of the clauses on the variable of lit into pp->buf
+// returns its size, or (c2dSize)-1 if it is a tautology
+static c2dSize resolve(Preprocessor* pp, const PpClause* pos, const PpClause* neg, c2dLitCode lit) {
+  ensure_buf(pp, pos->size + neg->size);
+  c2dSize size = 0;
+  for (c2dSize i = 0; i < pos->size; i++) {
+    if (pos->lits[i] == lit) continue;
+    pp->marks[pos->lits[i]] = 1;
+    pp->buf[size++] = pos->lits[i];
+  }
+  BOOLEAN tautology = 0;
+  for (c2dSize i = 0; i < neg->size && !tautology; i++) {
+    c2dLitCode q = neg->lits[i];
+    if (q == code_op(lit) || pp->marks[q]) continue;
+    if (pp->marks[code_op(q)]) tautology = 1;
+    else pp->buf[size++] = q;
+  }
+  for (c2dSize i = 0; i < pos->size; i++) pp->marks[pos->lits[i]] = 0;
+  pp->steps += pos->size + neg->size;
+  return tautology ? (c2dSize)-1 : size;
+}
+
+// eliminates the variable if its resolvents are no more than its clauses, returns 1 if it did
+static BOOLEAN eliminate_var(Preprocessor* pp, c2dSize var, c2dLitCode** resolvents, c2dSize* cap) {
+  PpList* pos = &(pp->occs[2 * var]);
+  PpList* neg = &(pp->occs[2 * var + 1]);
+  if (pos->size + neg->size == 0) return 0;
+  if (pos->size > ELIM_OCCURRENCES && neg->size > ELIM_OCCURRENCES) return 0;
+
+  // The resolvents are collected first, each one followed by 0
+  c2dSize num_resolvents = 0, len = 0;
+  for (c2dSize i = 0; i < pos->size; i++) {
+    for (c2dSize j = 0; j < neg->size; j++) {
+      c2dSize size = resolve(pp, &(pp->clauses[pos->items[i]]), &(pp->clauses[neg->items[j]]), 2 * var);
+      if (size == (c2dSize)-1) continue;
+      if (size > ELIM_RESOLVENT_SIZE || ++num_resolvents > pos->size + neg->size) return 0;
+      if (len + size + 1 > *cap) {
+        while (len + size + 1 > *cap) *cap *= 2;
+        *resolvents = realloc(*resolvents, sizeof(c2dLitCode) * *cap);
+      }
+      memcpy(*resolvents + len, pp->buf, sizeof(c2dLitCode) * size);
+      len += size;
+      (*resolvents)[len++] = 0;
+    }
+  }
+
+  for (c2dLitCode lit = 2 * var; lit <= 2 * var + 1; lit++) {
+    PpList* occs = &(pp->occs[lit]);
+    while (occs->size > 0) {
+      PpClause* clause = &(pp->clauses[occs->items[0]]);
+      push_reconstruction(pp, clause->lits, clause->size, lit);
+      remove_clause(pp, occs->items[0]);
+    }
+  }
+  pp->eliminated[var] = 1;
+  ++pp->num_eliminated;
+
+  for (c2dSize i = 0; i < len && !pp->unsat;) {
+    c2dSize size = 0;
+    while ((*resolvents)[i + size] != 0) ++size;
+    ensure_buf(pp, size);
+    memcpy(pp->buf, *resolvents + i, sizeof(c2dLitCode) * size);
+    add_clause(pp, pp->buf, size);
+    i += size + 1;
+  }
+  propagate_units(pp);
+  return 1;
+}
+
+static void eliminate(Preprocessor* pp) {
+  // Variables with fewer occurrences are tried first
+  c2dSize max_occs = 0;
+  for (c2dSize var = 1; var <= pp->num_vars; var++) {
+    c2dSize n = pp->occs[2 * var].size + pp->occs[2 * var + 1].size;
+    if (n > max_occs) max_occs = n;
+  }
+  c2dSize* start = calloc(max_occs + 2, sizeof(c2dSize));
+  for (c2dSize var = 1; var <= pp->num_vars; var++) ++start[pp->occs[2 * var].size + pp->occs[2 * var + 1].size + 1];
+  for (c2dSize n = 1; n <= max_occs + 1; n++) start[n] += start[n - 1];
+  c2dSize* vars = malloc(sizeof(c2dSize) * (pp->num_vars + 1));
+  for (c2dSize var = 1; var <= pp->num_vars; var++) vars[start[pp->occs[2 * var].size + pp->occs[2 * var + 1].size]++] = var;
+  free(start);
+
+  c2dSize cap = 256;
+  c2dLitCode* resolvents = malloc(sizeof(c2dLitCode) * cap);
+  for (c2dSize i = 0; i < pp->num_vars && !pp->unsat && pp->steps < PREPROCESS_STEPS; i++) {
+    c2dSize var = vars[i];
+    if (pp->values[2 * var] == 0 && !pp->eliminated[var]) eliminate_var(pp, var, &resolvents, &cap);
+  }
+  free(resolvents);
+  free(vars);
+}
+
+/******************************************************************************
+ * Driver
+ ******************************************************************************/
+
+static void preprocessor_init(Preprocessor* pp, SatState* sat_state) {
+  c2dSize num_codes = 2 * (sat_state->num_vars + 1);
+  pp->num_vars = sat_state->num_vars;
+  pp->clauses_cap = sat_state->num_cnf_clauses + 1;
+  pp->clauses = malloc(sizeof(PpClause) * pp->clauses_cap);
+  pp->num_clauses = 0;
+  pp->occs = malloc(sizeof(PpList) * num_codes);
+  for (c2dSize i = 0; i < num_codes; i++) pp->occs[i].size = pp->occs[i].cap = 0;
+  for (c2dSize i = 1; i <= sat_state->num_cnf_clauses; i++) {
+    Clause* clause = sat_state->cnf_clauses[i];
+    for (c2dSize j = 0; j < clause->size; j++) ++pp->occs[clause->lits[j]].cap;
+  }
+  for (c2dSize i = 0; i < num_codes; i++) pp->occs[i].items = malloc(sizeof(c2dSize) * (pp->occs[i].cap + 1));
+  pp->blocks = NULL;
+  pp->num_blocks = 0;
+  pp->block_used = 0;
+  pp->values = calloc(num_codes, sizeof(BOOLEAN));
+  pp->units = malloc(sizeof(c2dLitCode) * (sat_state->num_vars + 1));
+  pp->num_units = 0;
+  pp->units_head = 0;
+  pp->marks = calloc(num_codes, sizeof(BOOLEAN));
+  pp->buf_cap = 64;
+  pp->buf = malloc(sizeof(c2dLitCode) * pp->buf_cap);
+  pp->stack = sat_state->elim_stack;
+  pp->stack_size = pp->stack_cap = sat_state->elim_size;
+  pp->eliminated = sat_state->eliminated;
+  pp->num_eliminated = 0;
+  pp->steps = 0;
+  pp->unsat = 0;
+
+  for (c2dSize i = 1; i <= sat_state->num_cnf_clauses && !pp->unsat; i++) {
+    Clause* clause = sat_state->cnf_clauses[i];
+    ensure_buf(pp, clause->size);
+    memcpy(pp->buf, clause->lits, sizeof(c2dLitCode) * clause->size);
+    add_clause(pp, pp->buf, clause->size);
+  }
+}
+
+static void preprocessor_free(Preprocessor* pp) {
+  for (c2dSize i = 0; i < pp->num_blocks; i++) free(pp->blocks[i]);
+  free(pp->blocks);
+  for (c2dSize i = 0; i < 2 * (pp->num_vars + 1); i++) free(pp->occs[i].items);
+  free(pp->clauses);
+  free(pp->occs);
+  free(pp->values);
+  free(pp->units);
+  free(pp->marks);
+  free(pp->buf);
+}
+
+//simplifies the cnf of sat state, which must be called before the first unit resolution
+//(it does nothing otherwise); eliminated variables cannot be used by clauses added later
+//or as assumptions
+//returns 0 if the cnf is found unsatisfiable, 1 otherwise
+BOOLEAN sat_preprocess(SatState* sat_state) {
+  if (sat_state->unit_resolution_s != UNIT_RESOLUTION_FIRST_TIME || sat_state->trail_size > 0 ||
+      sat_state->num_learned_clauses > 0) {
+    return !sat_state->inconsistent;
+  }
+  double start = sat_clock();
+
+  Preprocessor pp;
+  preprocessor_init(&pp, sat_state);
+  propagate_units(&pp);
+  if (!pp.unsat) substitute_equivalences(&pp);
+  if (!pp.unsat) subsume(&pp);
+  if (!pp.unsat) eliminate(&pp);
+
+  // The units are kept as unit clauses, the first unit resolution assigns them again
+  c2dSize num_clauses = 0, len = 0;
+  c2dLitCode* codes;
+  if (pp.unsat) {
+    // a variable and its negation stand for the empty clause, which a cnf cannot hold
+    codes = malloc(sizeof(c2dLitCode) * 4);
+    if (pp.num_vars > 0) {
+      codes[len++] = 2, codes[len++] = 0, codes[len++] = 3, codes[len++] = 0;
+      num_clauses = 2;
+    }
+  } else {
+    c2dSize total = 2 * pp.num_units;
+    for (c2dSize id = 0; id < pp.num_clauses; id++) {
+      if (!pp.clauses[id].removed) total += pp.clauses[id].size + 1;
+    }
+    codes = malloc(sizeof(c2dLitCode) * (total + 1));
+    for (c2dSize i = 0; i < pp.num_units; i++) {
+      codes[len++] = pp.units[i];
+      codes[len++] = 0;
+      ++num_clauses;
+    }
+    for (c2dSize id = 0; id < pp.num_clauses; id++) {
+      PpClause* clause = &(pp.clauses[id]);
+      if (clause->removed) continue;
+      memcpy(codes + len, clause->lits, sizeof(c2dLitCode) * clause->size);
+      len += clause->size;
+      codes[len++] = 0;
+      ++num_clauses;
+    }
+  }
+
+  if (!pp.unsat || pp.num_vars > 0) replace_cnf_clauses(sat_state, codes, num_clauses);
+  sat_state->elim_stack = pp.stack;
+  sat_state->elim_size = pp.stack_size;
+  sat_state->num_eliminated_vars += pp.num_eliminated;
+  free(codes);
+
+  BOOLEAN unsat = pp.unsat;
+  preprocessor_free(&pp);
+  sat_state->preprocess_time += sat_clock() - start;
+  return !unsat;
+}
+
+//gives values to the eliminated variables, once the other ones satisfy the cnf
+//the values are set in the model, and on the trail at a new decision level
+void extend_model(SatState* sat_state) {
+  if (sat_state->num_eliminated_vars == 0) return;
+  BOOLEAN* model = sat_state->model;
+  const c2dLitCode* stack = sat_state->elim_stack;
+  for (c2dSize top = sat_state->elim_size; top > 0;) {
+    c2dSize size = stack[top - 1];
+    top -= size + 1;
+    BOOLEAN satisfied = 0;
+    for (c2dSize i = 0; i < size && !satisfied; i++) {
+      c2dLitCode lit = stack[top + i];
+      satisfied = (model[code_var(lit)] > 0) == !(lit & 1);
+    }
+    if (!satisfied) model[code_var(stack[top])] = (stack[top] & 1) ? -1 : 1;
+  }
+
+  ++sat_state->cur_level;
+  for (c2dSize var = 1; var <= sat_state->num_vars; var++) {
+    if (sat_state->eliminated[var]) assign_literal(model[var] > 0 ? 2 * var : 2 * var + 1, sat_state);
+  }
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
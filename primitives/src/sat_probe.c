@@ -0,0 +1,123 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Probing
+ *
+ * At the first decision level, each free variable is decided both ways:
+ * --if a value leads to a conflict (a failed literal), the clause learned from
+ * the conflict is asserted, which sets the variable the other way
+ * --the literals implied by both values hold at the first level, and are learned
+ * as units
+ * --a literal implied through a longer clause when probing lit is learned as the
+ * binary clause (-lit x), a hyper-binary resolvent, so that later propagations
+ * reach it through the implication lists
+ *
+ * The rounds are bounded by the number of propagated literals, and start where
+ * the previous round stopped, so sat_solve() can run them between restarts.
+ ******************************************************************************/
+
+#define HYPER_BINARY_LIMIT 8    // hyper-binary resolvents learned per probed literal
+
+//sets when sat_solve() probes: every interval conflicts (0 disables it), propagating at most
+//budget literals each time
+void sat_set_probe_schedule(SatState* sat_state, c2dSize interval, c2dSize budget) {
+  sat_state->probe_interval = interval;
+  sat_state->probe_budget = budget;
+  sat_state->next_probe = sat_state->num_conflicts + interval;
+}
+
+// decides lit, and keeps the literals it implies in implied
+// returns 1 if lit failed: the learned clause is asserted then and *ok tells whether the cnf
+// is still satisfiable
+static BOOLEAN probe_literal(Lit* lit, SatState* sat_state, c2dLitCode* implied, c2dSize* num_implied,
+                             c2dSize* work, BOOLEAN* ok) {
+  c2dSize start = sat_state->trail_size;
+  Clause* learned = sat_decide_literal(lit, sat_state);
+  *work += sat_state->trail_size - start;
+  if (learned != NULL) {
+    ++sat_state->num_failed_literals;
+    sat_undo_decide_literal(sat_state);
+    *ok = assert_at_first_level(learned, sat_state);
+    return 1;
+  }
+
+  // Hyper-binary resolvents are learned after going back to the first level
+  c2dLitCode binary[HYPER_BINARY_LIMIT][2];
+  c2dSize num_binary = 0;
+  *num_implied = 0;
+  for (c2dSize i = start + 1; i < sat_state->trail_size; i++) {
+    c2dLitCode q = sat_state->trail[i];
+    implied[(*num_implied)++] = q;
+    Clause* reason = sat_state->reasons[code_var(q)];
+    if (num_binary < HYPER_BINARY_LIMIT && reason != NULL && !is_binary_reason(reason) &&
+        reason->size > 2) {
+      binary[num_binary][0] = code_op(lit->code);
+      binary[num_binary++][1] = q;
+    }
+  }
+  sat_undo_decide_literal(sat_state);
+
+  *ok = 1;
+  for (c2dSize i = 0; i < num_binary && *ok; i++) {
+    if (sat_state->values[binary[i][0]] == 0 && sat_state->values[binary[i][1]] == 0) {
+      *ok = learn_implied_clause(binary[i], 2, sat_state);
+    }
+  }
+  return 0;
+}
+
+//decides the free variables both ways at the first decision level, learning failed literals,
+//literals implied by both values, and hyper-binary resolvents; stops after propagating about
+//budget literals, and the next call goes on from there
+//returns 0 if the cnf is found unsatisfiable, 1 otherwise
+BOOLEAN sat_probe(SatState* sat_state, c2dSize budget) {
+  if (sat_state->inconsistent) return 0;
+  sat_backtrack_to_level(1, sat_state);
+  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_FIRST_TIME && !sat_unit_resolution(sat_state)) {
+    sat_state->inconsistent = 1;
+    return 0;
+  }
+  sat_state->next_probe = sat_state->num_conflicts + sat_state->probe_interval;
+  double start = sat_clock();
+
+  c2dSize num_vars = sat_state->num_vars;
+  c2dLitCode* implied = malloc(sizeof(c2dLitCode) * (num_vars + 1));
+  c2dLitCode* units = malloc(sizeof(c2dLitCode) * (num_vars + 1));
+  BOOLEAN* marks = calloc(2 * (num_vars + 1), sizeof(BOOLEAN));
+  c2dSize work = 0;
+  BOOLEAN ok = 1;
+
+  for (c2dSize n = 0; n < num_vars && work < budget && ok; n++) {
+    c2dSize var = sat_state->probe_next_var;
+    sat_state->probe_next_var = var == num_vars ? 1 : var + 1;
+    if (sat_state->levels[var] != 0 || sat_state->eliminated[var]) continue;
+
+    c2dSize num_pos = 0, num_neg = 0;
+    if (probe_literal(sat_state->p_literals[var], sat_state, implied, &num_pos, &work, &ok)) continue;
+    if (!ok) break;
+    for (c2dSize i = 0; i < num_pos; i++) marks[implied[i]] = 1;
+
+    BOOLEAN failed = probe_literal(sat_state->n_literals[var], sat_state, units, &num_neg, &work, &ok);
+    c2dSize num_units = 0;
+    if (!failed) {
+      for (c2dSize i = 0; i < num_neg; i++) {
+        if (marks[units[i]]) units[num_units++] = units[i];
+      }
+    }
+    for (c2dSize i = 0; i < num_pos; i++) marks[implied[i]] = 0;
+
+    for (c2dSize i = 0; i < num_units && ok; i++) {
+      if (sat_state->values[units[i]] == 0) ok = learn_implied_clause(&(units[i]), 1, sat_state);
+    }
+  }
+
+  free(implied);
+  free(units);
+  free(marks);
+  sat_state->probe_time += sat_clock() - start;
+  return ok;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,82 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Restarts
+ *
+ * A restart undoes all decisions but keeps everything learned so far (clauses,
+ * variable activities and saved phases), so the search continues from a
+ * different, usually better, part of the space.
+ *
+ * The Luby policy restarts on a fixed schedule. The glucose policy compares a
+ * fast moving average of the lbd of the learned clauses with a slow one, and
+ * restarts when the recent clauses are clearly worse than usual.
+ ******************************************************************************/
+
+#define LUBY_UNIT 100
+#define GLUCOSE_MIN_CONFLICTS 50  // conflicts between two glucose restarts, at least
+#define GLUCOSE_MARGIN 0.8        // restart when lbd_fast * GLUCOSE_MARGIN > lbd_slow
+#define EMA_FAST (1.0 / 32)
+#define EMA_SLOW (1.0 / 16384)
+
+// returns the i^th term of the Luby sequence, i starts from 1
+static c2dSize luby(c2dSize i) {
+  c2dSize size = 1;
+  while (size < i + 1) size = 2 * size + 1;  // size = 2^k - 1 is the length of a full prefix
+  while (size > 1) {
+    if (i == size) return (size + 1) / 2;
+    size /= 2;
+    if (i > size) i -= size;
+  }
+  return 1;
+}
+
+//sets the restart policy (RESTART_NONE, RESTART_LUBY or RESTART_GLUCOSE)
+void sat_set_restart_policy(SatState* sat_state, c2dSize policy) {
+  sat_state->restart_policy = policy;
+  sat_state->restart_conflicts = 0;
+  sat_state->restart_limit = LUBY_UNIT * luby(sat_state->num_restarts + 1);
+  sat_state->lbd_fast = 0;
+  sat_state->lbd_slow = 0;
+}
+
+// the first averages are taken over the conflicts seen so far, so that they are not biased
+// toward 0 at the beginning
+static inline double moving_average(double avg, double value, double alpha, c2dSize count) {
+  if (alpha < 1.0 / count) alpha = 1.0 / count;
+  return avg + alpha * (value - avg);
+}
+
+//counts a conflict toward the next restart, and updates the lbd averages with the lbd of the
+//clause learned from it (called by sat_unit_resolution() on a conflict)
+void restart_on_conflict(unsigned int lbd, SatState* sat_state) {
+  ++sat_state->restart_conflicts;
+  if (sat_state->restart_policy == RESTART_GLUCOSE) {
+    sat_state->lbd_fast = moving_average(sat_state->lbd_fast, lbd, EMA_FAST, sat_state->restart_conflicts);
+    sat_state->lbd_slow = moving_average(sat_state->lbd_slow, lbd, EMA_SLOW, sat_state->num_conflicts);
+  }
+}
+
+//returns 1 if the restart policy asks for a restart, 0 otherwise
+BOOLEAN sat_restart_due(const SatState* sat_state) {
+  switch (sat_state->restart_policy) {
+    case RESTART_LUBY:
+      return sat_state->restart_conflicts >= sat_state->restart_limit;
+    case RESTART_GLUCOSE:
+      return sat_state->restart_conflicts >= GLUCOSE_MIN_CONFLICTS &&
+             sat_state->lbd_fast * GLUCOSE_MARGIN > sat_state->lbd_slow;
+    default:
+      return 0;
+  }
+}
+
+//backtracks to the first decision level, and starts counting conflicts toward the next restart
+void sat_restart(SatState* sat_state) {
+  sat_backtrack_to_level(1, sat_state);
+  ++sat_state->num_restarts;
+  sat_state->restart_conflicts = 0;
+  sat_state->restart_limit = LUBY_UNIT * luby(sat_state->num_restarts + 1);
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
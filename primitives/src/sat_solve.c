@@ -0,0 +1,196 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Search
+ *
+ * The CDCL loop: decide the literal picked by the decision heuristic, and on a
+ * conflict backtrack to the assertion level of the learned clause and assert
+ * it, until either all variables are instantiated or the empty clause is
+ * learned. The recursion of a hand written driver is replaced by the trail, so
+ * the depth of the search does not depend on the C stack.
+ *
+ * Assumptions take the decision levels right above the first one. When one of
+ * them is false, the assumptions it depends on are collected from the trail,
+ * and the cnf is unsatisfiable under them; nothing learned is lost, since
+ * learned clauses never depend on the assumptions.
+ ******************************************************************************/
+
+#define TIME_CHECK_PERIOD 256  // decisions between two checks of the time limit
+
+//sets the budget of each sat_solve() call: the number of conflicts, the number of decisions,
+//and the number of seconds; 0 means no limit
+void sat_set_solve_limits(SatState* sat_state, c2dSize conflicts, c2dSize decisions, double seconds) {
+  sat_state->conflict_limit = conflicts;
+  sat_state->decision_limit = decisions;
+  sat_state->time_limit = seconds;
+}
+
+//makes the sat_solve() calls of sat state return SAT_UNKNOWN as soon as *flag is set (by another
+//thread, or a signal handler), NULL to stop watching it; the flag is read with an acquire load,
+//so another thread should set it with a release store (__atomic_store_n)
+void sat_set_interrupt(SatState* sat_state, const volatile BOOLEAN* flag) {
+  sat_state->interrupt = flag;
+}
+
+static BOOLEAN out_of_budget(const SatState* sat_state, c2dSize conflicts, c2dSize decisions, double start) {
+  if (sat_state->interrupt != NULL && __atomic_load_n(sat_state->interrupt, __ATOMIC_ACQUIRE)) return 1;
+  if (sat_state->conflict_limit > 0 && sat_state->num_conflicts - conflicts >= sat_state->conflict_limit) return 1;
+  c2dSize num_decisions = sat_state->num_decisions - decisions;
+  if (sat_state->decision_limit > 0 && num_decisions >= sat_state->decision_limit) return 1;
+  return sat_state->time_limit > 0 && num_decisions % TIME_CHECK_PERIOD == 0 &&
+         sat_clock() - start >= sat_state->time_limit;
+}
+
+static void save_model(SatState* sat_state) {
+  for (c2dSize i = 1; i <= sat_state->num_vars; i++) {
+    sat_state->model[i] = sat_state->values[2 * i] > 0 ? 1 : -1;
+  }
+}
+
+// collects the assumptions which imply the negation of the assumption lit
+static void analyze_final(c2dLitCode lit, SatState* sat_state) {
+  c2dLiteral* failed = sat_state->failed_assumptions;
+  c2dSize num_failed = 0;
+  failed[num_failed++] = code_index(lit);
+
+  // The trail is ordered by level, so the walk stops at the first level
+  BOOLEAN* seen = sat_state->seen;
+  seen[code_var(lit)] = 1;
+  for (c2dSize i = sat_state->trail_size; i-- > 0;) {
+    c2dLitCode q = sat_state->trail[i];
+    c2dSize var = code_var(q);
+    if (sat_state->levels[var] <= 1) break;
+    if (!seen[var]) continue;
+    seen[var] = 0;
+
+    Clause* reason = sat_state->reasons[var];
+    if (reason == NULL) {
+      // decisions made during the assumption phase are assumptions
+      failed[num_failed++] = code_index(q);
+    } else {
+      c2dLitCode binary[2];
+      c2dSize size;
+      const c2dLitCode* lits = reason_lits(reason, q, binary, &size);
+      for (c2dSize j = 1; j < size; j++) {
+        if (sat_state->levels[code_var(lits[j])] > 1) seen[code_var(lits[j])] = 1;
+      }
+    }
+  }
+  seen[code_var(lit)] = 0;
+  sat_state->num_failed_assumptions = num_failed;
+}
+
+// returns the next assumption to decide, NULL once all of them hold; sets *failed when the
+// next one is false. An assumption which holds already gets an empty decision level, so
+// that the level still tells how many assumptions have been made
+static Lit* next_assumption(const c2dLiteral* assumptions, c2dSize num_assumptions,
+                            SatState* sat_state, BOOLEAN* failed) {
+  while (sat_state->cur_level - 1 < num_assumptions) {
+    c2dLiteral index = assumptions[sat_state->cur_level - 1];
+    c2dLitCode lit = lit_code(index);
+    if (sat_state->values[lit] < 0) {
+      analyze_final(lit, sat_state);
+      *failed = 1;
+      return NULL;
+    }
+    if (sat_state->values[lit] == 0) return sat_index2literal(index, sat_state);
+    ++sat_state->cur_level;
+  }
+  return NULL;
+}
+
+//decides the satisfiability of the cnf of sat state
+//returns SAT_SATISFIABLE, SAT_UNSATISFIABLE, or SAT_UNKNOWN when the budget runs out
+int sat_solve(SatState* sat_state) {
+  return sat_solve_with_assumptions(NULL, 0, sat_state);
+}
+
+// the search of sat_solve_with_assumptions(), from start
+static int search(const c2dLiteral* assumptions, c2dSize num_assumptions, double start, SatState* sat_state) {
+  c2dSize conflicts = sat_state->num_conflicts;
+  c2dSize decisions = sat_state->num_decisions;
+
+  sat_backtrack_to_level(1, sat_state);
+  if (sat_state->unit_resolution_s == UNIT_RESOLUTION_FIRST_TIME && !sat_unit_resolution(sat_state)) {
+    sat_state->inconsistent = 1;
+    return SAT_UNSATISFIABLE;
+  }
+
+  for (;;) {
+    if (out_of_budget(sat_state, conflicts, decisions, start)) {
+      sat_backtrack_to_level(1, sat_state);
+      return SAT_UNKNOWN;
+    }
+    BOOLEAN failed = 0;
+    Lit* lit = next_assumption(assumptions, num_assumptions, sat_state, &failed);
+    if (failed) {
+      sat_backtrack_to_level(1, sat_state);
+      return SAT_UNSATISFIABLE;
+    }
+    if (lit == NULL) lit = sat_next_decision(sat_state);
+    if (lit == NULL) {
+      // the satisfying assignment is left in place
+      save_model(sat_state);
+      extend_model(sat_state);
+      return SAT_SATISFIABLE;
+    }
+
+    Clause* learned = sat_decide_literal(lit, sat_state);
+    while (learned != NULL) {
+      if (learned->size == 0) {
+        sat_state->inconsistent = 1;
+        return SAT_UNSATISFIABLE;
+      }
+      sat_backtrack_to_level(learned->assertion_level, sat_state);
+      learned = sat_assert_clause(learned, sat_state);
+    }
+
+    if (sat_restart_due(sat_state)) {
+      sat_restart(sat_state);
+      if (!sat_import_clauses(sat_state)) return SAT_UNSATISFIABLE;
+      if (sat_state->probe_interval > 0 && sat_state->num_conflicts >= sat_state->next_probe &&
+          !sat_probe(sat_state, sat_state->probe_budget)) {
+        return SAT_UNSATISFIABLE;
+      }
+    }
+  }
+}
+
+//decides the satisfiability of the cnf of sat state together with the assumed literals,
+//which are decided first, one per decision level (so they are part of the model on SAT)
+//on SAT_UNSATISFIABLE, sat_failed_assumptions() gives the assumptions which caused it
+//returns SAT_UNKNOWN if one of the assumptions is not a literal of the cnf (or its variable has
+//been eliminated by sat_preprocess())
+int sat_solve_with_assumptions(const c2dLiteral* assumptions, c2dSize num_assumptions, SatState* sat_state) {
+  sat_state->num_failed_assumptions = 0;
+  for (c2dSize i = 0; i < num_assumptions; i++) {
+    c2dSize var = (c2dSize)labs(assumptions[i]);
+    if (var == 0 || var > sat_state->num_vars || sat_state->eliminated[var]) return SAT_UNKNOWN;
+  }
+  if (sat_state->inconsistent) return SAT_UNSATISFIABLE;
+
+  // an assumption which holds already takes an empty level, so the levels can go up to
+  // num_vars + num_assumptions + 1
+  reserve_levels(sat_state->num_vars + num_assumptions + 2, sat_state);
+  double start = sat_clock();
+  int result = search(assumptions, num_assumptions, start, sat_state);
+  sat_state->search_time += sat_clock() - start;
+  return result;
+}
+
+//returns the assumptions which made the last sat_solve_with_assumptions() call unsatisfiable,
+//and sets *size to their number; it is empty when the cnf itself is unsatisfiable
+const c2dLiteral* sat_failed_assumptions(const SatState* sat_state, c2dSize* size) {
+  *size = sat_state->num_failed_assumptions;
+  return sat_state->failed_assumptions;
+}
+
+//returns the model found by the last sat_solve() call which returned SAT_SATISFIABLE,
+//by variable index: 1 if the variable is true, -1 if it is false
+const BOOLEAN* sat_model(const SatState* sat_state) {
+  return sat_state->model;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -0,0 +1,104 @@
+#include "sat_api.h"
+
+/******************************************************************************
+ * Subsumption tracking
+ *
+ * Every cnf clause counts its true literals, and every variable the occurrences
+ * of its cnf clauses which have none. Setting a literal visits the cnf clauses
+ * containing it, and only a clause which becomes subsumed visits its variables;
+ * undoing the literal does the opposite. A variable occurring twice in a clause
+ * is counted twice, as in its occurrence list.
+ ******************************************************************************/
+
+// starts tracking a cnf clause, against the current assignment
+static void track_clause(Clause* clause, SatState* sat_state) {
+  c2dSize true_count = 0;
+  for (c2dSize i = 0; i < clause->size; i++) {
+    ClauseList* occurrences = &(sat_state->occurrences[clause->lits[i]]);
+    clause_pointer_push(clause, &(occurrences->clauses), &(occurrences->size), &(occurrences->cap));
+    if (sat_state->values[clause->lits[i]] > 0) ++true_count;
+  }
+  sat_state->true_counts[clause->index] = true_count;
+  if (true_count > 0) return;
+  for (c2dSize i = 0; i < clause->size; i++) ++sat_state->unsubsumed_counts[code_var(clause->lits[i])];
+}
+
+// counts the cnf clauses from scratch, the occurrence lists are sized exactly
+static void build_subsumption_counts(SatState* sat_state) {
+  c2dSize num_codes = 2 * (sat_state->num_vars + 1);
+  if (sat_state->occurrences == NULL) sat_state->occurrences = calloc(num_codes, sizeof(ClauseList));
+  for (c2dSize i = 0; i < num_codes; i++) sat_state->occurrences[i].size = 0;
+  for (c2dSize i = 1; i <= sat_state->num_cnf_clauses; i++) {
+    const Clause* clause = sat_state->cnf_clauses[i];
+    for (c2dSize j = 0; j < clause->size; j++) ++sat_state->occurrences[clause->lits[j]].size;
+  }
+  for (c2dSize i = 0; i < num_codes; i++) {
+    ClauseList* occurrences = &(sat_state->occurrences[i]);
+    if (occurrences->size + 1 > occurrences->cap) {
+      occurrences->cap = occurrences->size + 2;
+      occurrences->clauses = realloc(occurrences->clauses, sizeof(Clause*) * occurrences->cap);
+    }
+    occurrences->size = 0;
+  }
+  free(sat_state->true_counts);
+  sat_state->true_counts = malloc(sizeof(c2dSize) * sat_state->cnf_cap);
+  free(sat_state->unsubsumed_counts);
+  sat_state->unsubsumed_counts = calloc(sat_state->num_vars + 1, sizeof(c2dSize));
+  for (c2dSize i = 1; i <= sat_state->num_cnf_clauses; i++) track_clause(sat_state->cnf_clauses[i], sat_state);
+}
+
+static void free_subsumption_counts(SatState* sat_state) {
+  if (sat_state->occurrences != NULL) {
+    for (c2dSize i = 0; i < 2 * (sat_state->num_vars + 1); i++) free(sat_state->occurrences[i].clauses);
+  }
+  free(sat_state->occurrences);
+  free(sat_state->true_counts);
+  free(sat_state->unsubsumed_counts);
+  sat_state->occurrences = NULL;
+  sat_state->true_counts = NULL;
+  sat_state->unsubsumed_counts = NULL;
+}
+
+//turns on (1) or off (0) the counts which make sat_irrelevant_var() and sat_subsumed_clause()
+//take constant time; they are updated whenever a literal is set or unset, so they are off by
+//default
+void sat_set_subsumption_tracking(SatState* sat_state, BOOLEAN on) {
+  if (on) build_subsumption_counts(sat_state);
+  else free_subsumption_counts(sat_state);
+}
+
+// counts the cnf clauses again after they have been replaced, if the counts are kept
+void subsumption_clauses_replaced(SatState* sat_state) {
+  if (sat_state->occurrences != NULL) build_subsumption_counts(sat_state);
+}
+
+// counts a cnf clause added to the sat state, if the counts are kept
+void subsumption_clause_added(Clause* clause, SatState* sat_state) {
+  if (sat_state->occurrences == NULL) return;
+  sat_state->true_counts = realloc(sat_state->true_counts, sizeof(c2dSize) * sat_state->cnf_cap);
+  track_clause(clause, sat_state);
+}
+
+// lit has become true
+void subsumption_assigned(c2dLitCode lit, SatState* sat_state) {
+  const ClauseList* occurrences = &(sat_state->occurrences[lit]);
+  for (c2dSize i = 0; i < occurrences->size; i++) {
+    const Clause* clause = occurrences->clauses[i];
+    if (sat_state->true_counts[clause->index]++ > 0) continue;
+    for (c2dSize j = 0; j < clause->size; j++) --sat_state->unsubsumed_counts[code_var(clause->lits[j])];
+  }
+}
+
+// lit is not true anymore
+void subsumption_unassigned(c2dLitCode lit, SatState* sat_state) {
+  const ClauseList* occurrences = &(sat_state->occurrences[lit]);
+  for (c2dSize i = 0; i < occurrences->size; i++) {
+    const Clause* clause = occurrences->clauses[i];
+    if (--sat_state->true_counts[clause->index] > 0) continue;
+    for (c2dSize j = 0; j < clause->size; j++) ++sat_state->unsubsumed_counts[code_var(clause->lits[j])];
+  }
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
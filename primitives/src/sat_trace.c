@@ -0,0 +1,275 @@
+#define _DEFAULT_SOURCE
+#include "sat_api.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+ * Tracing
+ *
+ * A tracer records the phases of the thread which started it. The hardware
+ * counters are opened with perf_event_open() as a single group, for that thread
+ * and user space only, so one read() gives all of them and the system call does
+ * not show up in the counts (it does in the times). When no counter can be opened
+ * (no PMU, or perf_event_paranoid too high) only the times are recorded.
+ *
+ * A phase nested in another one (conflict analysis runs inside unit resolution)
+ * is also counted in the outer one. The events of the timeline are kept in memory
+ * up to the limit given to sat_tracer_new(), later ones are only summed up.
+ ******************************************************************************/
+
+#define TRACE_MAX_DEPTH 8
+
+typedef struct trace_event {
+  TracePhase phase;
+  double start;  // seconds since the tracer was started
+  double duration;
+  uint64_t counters[TRACE_NUM_COUNTERS];
+} TraceEvent;
+
+struct sat_tracer {
+  int group;                        // group leader, -1 if no counter is open
+  int fds[TRACE_NUM_COUNTERS];      // -1 for the counters which could not be opened
+  int slots[TRACE_NUM_COUNTERS];    // position of the counters in a group read
+  int num_open;
+  BOOLEAN started;
+  double origin;
+
+  c2dSize calls[TRACE_NUM_PHASES];
+  double times[TRACE_NUM_PHASES];
+  uint64_t totals[TRACE_NUM_PHASES][TRACE_NUM_COUNTERS];
+
+  c2dSize depth;  // open phases, the ones past TRACE_MAX_DEPTH are ignored
+  TracePhase open_phases[TRACE_MAX_DEPTH];
+  double open_starts[TRACE_MAX_DEPTH];
+  uint64_t open_counters[TRACE_MAX_DEPTH][TRACE_NUM_COUNTERS];
+
+  TraceEvent* events;
+  c2dSize num_events;
+  c2dSize events_cap;
+  c2dSize max_events;
+  c2dSize num_dropped;
+};
+
+// the tracer of the calling thread
+static __thread SatTracer* current_tracer = NULL;
+
+static const char* phase_names[TRACE_NUM_PHASES] = {
+  "parse", "unit resolution", "conflict analysis", "undo"
+};
+
+static const char* counter_names[TRACE_NUM_COUNTERS] = {
+  "cycles", "instructions", "branch misses", "L1d misses", "LLC misses"
+};
+
+//returns a tracer keeping up to max_events events for the timeline (0 for the summary only)
+SatTracer* sat_tracer_new(c2dSize max_events) {
+  SatTracer* tracer = calloc(1, sizeof(SatTracer));
+  tracer->group = -1;
+  for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+    tracer->fds[c] = -1;
+    tracer->slots[c] = -1;
+  }
+  tracer->max_events = max_events;
+  return tracer;
+}
+
+#ifdef __linux__
+static int open_counter(uint32_t type, uint64_t config, int group) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group < 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static uint64_t cache_miss_config(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+static void open_counters(SatTracer* tracer) {
+  const uint32_t types[TRACE_NUM_COUNTERS] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE
+  };
+  const uint64_t configs[TRACE_NUM_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+    cache_miss_config(PERF_COUNT_HW_CACHE_L1D), cache_miss_config(PERF_COUNT_HW_CACHE_LL)
+  };
+  for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+    int fd = open_counter(types[c], configs[c], tracer->group);
+    if (fd < 0) continue;
+    if (tracer->group < 0) tracer->group = fd;
+    tracer->fds[c] = fd;
+    tracer->slots[c] = tracer->num_open++;
+  }
+  if (tracer->group >= 0) {
+    ioctl(tracer->group, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(tracer->group, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+static void close_counters(SatTracer* tracer) {
+  // the group leader is closed last
+  for (int c = TRACE_NUM_COUNTERS - 1; c >= 0; c--) {
+    if (tracer->fds[c] >= 0) close(tracer->fds[c]);
+    tracer->fds[c] = -1;
+  }
+  tracer->group = -1;
+}
+
+static void read_counters(const SatTracer* tracer, uint64_t* counters) {
+  memset(counters, 0, sizeof(uint64_t) * TRACE_NUM_COUNTERS);
+  if (tracer->group < 0) return;
+  uint64_t values[1 + TRACE_NUM_COUNTERS];
+  if (read(tracer->group, values, sizeof(values)) < (ssize_t)sizeof(uint64_t)) return;
+  for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+    if (tracer->slots[c] >= 0 && (uint64_t)tracer->slots[c] < values[0]) counters[c] = values[1 + tracer->slots[c]];
+  }
+}
+#else
+static void open_counters(SatTracer* tracer) {}
+static void close_counters(SatTracer* tracer) {}
+static void read_counters(const SatTracer* tracer, uint64_t* counters) {
+  memset(counters, 0, sizeof(uint64_t) * TRACE_NUM_COUNTERS);
+}
+#endif
+
+//opens the counters of tracer for the calling thread, whose phases it records from now on
+void sat_tracer_start(SatTracer* tracer) {
+  if (tracer->started) return;
+  open_counters(tracer);
+  tracer->started = 1;
+  tracer->origin = sat_clock();
+  tracer->depth = 0;
+  current_tracer = tracer;
+}
+
+//stops recording the phases of the calling thread, and closes the counters of tracer
+void sat_tracer_stop(SatTracer* tracer) {
+  if (!tracer->started) return;
+  if (current_tracer == tracer) current_tracer = NULL;
+  close_counters(tracer);
+  tracer->started = 0;
+}
+
+//frees the tracer, stopping it first (from the thread which started it)
+void sat_tracer_free(SatTracer* tracer) {
+  sat_tracer_stop(tracer);
+  free(tracer->events);
+  free(tracer);
+}
+
+//returns the number of hardware counters the tracer could open
+c2dSize sat_tracer_num_counters(const SatTracer* tracer) {
+  return tracer->num_open;
+}
+
+//opens a phase in the tracer of the current thread, if any (called through SAT_TRACE_BEGIN)
+void sat_trace_begin(TracePhase phase) {
+  SatTracer* tracer = current_tracer;
+  if (tracer == NULL) return;
+  c2dSize depth = tracer->depth++;
+  if (depth >= TRACE_MAX_DEPTH) return;
+  tracer->open_phases[depth] = phase;
+  read_counters(tracer, tracer->open_counters[depth]);
+  tracer->open_starts[depth] = sat_clock();
+}
+
+//closes the phase opened last, which must be phase (called through SAT_TRACE_END)
+void sat_trace_end(TracePhase phase) {
+  SatTracer* tracer = current_tracer;
+  if (tracer == NULL || tracer->depth == 0) return;
+  c2dSize depth = --tracer->depth;
+  if (depth >= TRACE_MAX_DEPTH) return;
+  double end = sat_clock();
+  uint64_t counters[TRACE_NUM_COUNTERS];
+  read_counters(tracer, counters);
+  assert(tracer->open_phases[depth] == phase);
+
+  double duration = end - tracer->open_starts[depth];
+  ++tracer->calls[phase];
+  tracer->times[phase] += duration;
+  for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+    counters[c] -= tracer->open_counters[depth][c];
+    tracer->totals[phase][c] += counters[c];
+  }
+
+  if (tracer->num_events == tracer->max_events) {
+    ++tracer->num_dropped;
+    return;
+  }
+  if (tracer->num_events == tracer->events_cap) {
+    tracer->events_cap = tracer->events_cap == 0 ? 1024 : 2 * tracer->events_cap;
+    if (tracer->events_cap > tracer->max_events) tracer->events_cap = tracer->max_events;
+    tracer->events = realloc(tracer->events, sizeof(TraceEvent) * tracer->events_cap);
+  }
+  TraceEvent* event = &(tracer->events[tracer->num_events++]);
+  event->phase = phase;
+  event->start = tracer->open_starts[depth] - tracer->origin;
+  event->duration = duration;
+  memcpy(event->counters, counters, sizeof(counters));
+}
+
+//prints the calls, time and counters of every phase
+void sat_tracer_print_summary(const SatTracer* tracer, FILE* file) {
+#ifndef SAT_TRACE
+  fprintf(file, "c the library is built without SAT_TRACE, no phase is recorded\n");
+#endif
+  fprintf(file, "c %-18s %10s %10s", "phase", "calls", "seconds");
+  for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+    if (tracer->slots[c] >= 0) fprintf(file, " %14s", counter_names[c]);
+  }
+  if (tracer->slots[TRACE_CYCLES] >= 0 && tracer->slots[TRACE_INSTRUCTIONS] >= 0) fprintf(file, " %6s", "ipc");
+  fprintf(file, "\n");
+
+  for (int p = 0; p < TRACE_NUM_PHASES; p++) {
+    fprintf(file, "c %-18s %10lu %10.4f", phase_names[p], tracer->calls[p], tracer->times[p]);
+    for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+      if (tracer->slots[c] >= 0) fprintf(file, " %14llu", (unsigned long long)tracer->totals[p][c]);
+    }
+    if (tracer->slots[TRACE_CYCLES] >= 0 && tracer->slots[TRACE_INSTRUCTIONS] >= 0) {
+      uint64_t cycles = tracer->totals[p][TRACE_CYCLES];
+      fprintf(file, " %6.2f", cycles > 0 ? (double)tracer->totals[p][TRACE_INSTRUCTIONS] / cycles : 0.0);
+    }
+    fprintf(file, "\n");
+  }
+  if (tracer->num_open == 0) fprintf(file, "c no hardware counter available\n");
+  if (tracer->num_dropped > 0) fprintf(file, "c %lu events left out of the timeline\n", tracer->num_dropped);
+}
+
+//writes the recorded events in the Chrome trace format (for chrome://tracing or Perfetto)
+//returns 0 if the file cannot be written, 1 otherwise
+BOOLEAN sat_tracer_write_timeline(const SatTracer* tracer, const char* file_name) {
+  FILE* file = fopen(file_name, "w");
+  if (file == NULL) return 0;
+  fprintf(file, "{\"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_events\": %lu}, \"traceEvents\": [",
+          tracer->num_dropped);
+  for (c2dSize i = 0; i < tracer->num_events; i++) {
+    const TraceEvent* event = &(tracer->events[i]);
+    fprintf(file, "%s\n{\"name\": \"%s\", \"cat\": \"sat\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, "
+            "\"ts\": %.3f, \"dur\": %.3f, \"args\": {", i == 0 ? "" : ",", phase_names[event->phase],
+            event->start * 1e6, event->duration * 1e6);
+    BOOLEAN first = 1;
+    for (int c = 0; c < TRACE_NUM_COUNTERS; c++) {
+      if (tracer->slots[c] < 0) continue;
+      fprintf(file, "%s\"%s\": %llu", first ? "" : ", ", counter_names[c], (unsigned long long)event->counters[c]);
+      first = 0;
+    }
+    fprintf(file, "}}");
+  }
+  fprintf(file, "\n]}\n");
+  return fclose(file) == 0;
+}
+
+/******************************************************************************
+ * end
+ ******************************************************************************/
@@ -1,79 +1,52 @@
 #include "sat_api.h"
 
-#include "sat_api.h"
-
 /******************************************************************************
- * SAT solver 
+ * SAT solver
  ******************************************************************************/
 
-//returns a literal which is free in the current setting of sat state  
-//a NAIVE implementation no one would use in practice
-//you are free to modify this (no need though)
-Lit* get_free_literal(SatState* sat_state) {
-  c2dSize var_count = sat_var_count(sat_state);
-  for(c2dSize i=0; i<var_count; i++) { //go over variables
-    Var* var  = sat_index2var(i+1,sat_state); //note index is i+1, not i
-    Lit* plit = sat_pos_literal(var);
-    Lit* nlit = sat_neg_literal(var);
-    if(!sat_implied_literal(plit) && !sat_implied_literal(nlit)) return plit;
+//prints the result in the format of the sat competitions
+void print_result(int result, const BOOLEAN* model, c2dSize num_vars) {
+  if (result == SAT_SATISFIABLE) {
+    printf("s SATISFIABLE\nv");
+    for (c2dSize i = 1; i <= num_vars; i++) {
+      printf(" %ld", model[i] > 0 ? (c2dLiteral)i : -(c2dLiteral)i);
+    }
+    printf(" 0\n");
   }
-  return NULL; //all literals are implied
+  else if (result == SAT_UNSATISFIABLE) printf("s UNSATISFIABLE\n");
+  else printf("s UNKNOWN\n");
 }
 
-//if sat state is shown to be satisfiable, it returns NULL
-//otherwise, a clause must be learned and it is returned
-Clause* sat_aux(SatState* sat_state) {
-  printf("AUX\n");
-
-  Lit* lit = get_free_literal(sat_state);
-  if(lit==NULL) return NULL; //all literals are implied
-
-  printf("SELECT: %lu %lu\n", lit->index, sat_state->num_decided_literals);
-  Clause* learned = sat_decide_literal(lit,sat_state);
-  if(learned==NULL) learned = sat_aux(sat_state);
-
-  printf("Hi\n");
-  sat_undo_decide_literal(sat_state);
-  printf("UNDO OVER %lu\n", sat_state->cur_level);
-
-  if(learned!=NULL) { //there is a conflict
-    if(sat_at_assertion_level(learned,sat_state)) {
-      printf("WOW welcome\n");
-      learned = sat_assert_clause(learned,sat_state);
-
-      printf("WOW welcome welcome\n");
-      if(learned==NULL) return sat_aux(sat_state); //try again
-      else return learned; //new clause learned, backtrack
+//usage: test [cnf file] [number of threads]
+int main(int argc, char* argv[]) {
+  const char* file_name = argc > 1 ? argv[1] : "cnf.in1";
+  int num_threads = argc > 2 ? atoi(argv[2]) : 1;
+
+  if (num_threads > 1) {
+    //run a portfolio of searches over the parsed cnf
+    DimacsCnf* cnf = dimacs_read_file(file_name);
+    if (cnf == NULL) {
+      fprintf(stderr, "cannot read the cnf\n");
+      return 1;
     }
-    else return learned; //backtrack (still conflict)
+    BOOLEAN* model = malloc(sizeof(BOOLEAN) * (cnf->num_vars + 1));
+    int result = sat_portfolio_solve(cnf, num_threads, 0, model);
+    print_result(result, model, cnf->num_vars);
+    free(model);
+    dimacs_free(cnf);
+    return result;
   }
-  return NULL; //satisfiable
-}
-
-BOOLEAN sat(SatState* sat_state) {
-  BOOLEAN ret = 0;
-  if(sat_unit_resolution(sat_state)) ret = (sat_aux(sat_state)==NULL? 1: 0);
-  sat_undo_unit_resolution(sat_state); // everything goes back to the initial state
-  return ret;
-}
 
-void TEST_READ_FILE(SatState* st) {
-  // sat_state_debug(st);
-  // printf("sat_unit_resolution: %d\n", (int)sat_unit_resolution(st));
-  sat_state_debug(st);
-  printf("CAO\n");
-}
-
-int main(int argc, char* argv[]) {  
   //construct a sat state and then check satisfiability
-  SatState* sat_state = sat_state_new("cnf.in1");
-  
-  printf("CAO\n");
-  // TEST_READ_FILE(sat_state);
-  /*
-  if(sat(sat_state)) printf("SAT\n");
-  else printf("UNSAT\n");
+  SatState* sat_state = sat_state_new(file_name);
+  if (sat_state == NULL) {
+    fprintf(stderr, "cannot read the cnf\n");
+    return 1;
+  }
+
+  sat_preprocess(sat_state);
+  int result = sat_solve(sat_state);
+  print_result(result, sat_model(sat_state), sat_var_count(sat_state));
   sat_state_free(sat_state);
-  */
-  return 0;
+  return result;
 }
@@ -1,5 +1,6 @@
 make clean
 make
+mkdir -p lib
 cp libsat.a ./lib
 
-gcc test.c -std=c99 -O2 -Wall -Iinclude -Llib -lsat -o test
+gcc test.c -std=c99 -O2 -Wall -Iinclude -Llib -lsat -lpthread -lm -o test